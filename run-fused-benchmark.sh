@@ -0,0 +1,10 @@
+# FUSED CONJUNCTION-AND-QUANTIFICATION MICRO-BENCHMARK
+# Solves each Elevators instance with the current fixpoint step and with the
+# fused one. Results are stored in separate .csv files for comparison
+cd build/bin/
+
+for problem in p01 p02 p03 p04 p05 p06 p07 p08 p09 p10 p11 p12 p13 p14 p15
+do
+    timeout 1000 ./syft4fond -d ./../../Benchmarks/Elevators/domain.pddl -p ./../../Benchmarks/Elevators/$problem.pddl -o ./../../Benchmarks/Elevators/results-current.csv
+    timeout 1000 ./syft4fond -d ./../../Benchmarks/Elevators/domain.pddl -p ./../../Benchmarks/Elevators/$problem.pddl -q 1 -o ./../../Benchmarks/Elevators/results-fused.csv
+done
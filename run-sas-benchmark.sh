@@ -0,0 +1,25 @@
+# SAS READER MICRO-BENCHMARK
+# Translates each benchmark instance with translate.py and compares the
+# getline-based reader with SasReader on the resulting output.sas files.
+# Results are stored in ./Benchmarks/results-sas-reader.csv
+cd build/bin/
+
+sas_dir=$(mktemp -d)
+
+benchmarks=$(cd ./../../Benchmarks && pwd)
+translate_py=$(cd ./../../submodules && pwd)/translate.py
+
+for problem in p01 p02 p03 p04 p05 p06 p07 p08 p09 p10 p11 p12 p13 p14 p15
+do
+    (cd $sas_dir && timeout 1000 $translate_py 0 $benchmarks/Elevators/domain.pddl $benchmarks/Elevators/$problem.pddl > /dev/null && mv output.sas elevators-$problem.sas)
+done
+
+for problem in p1 p2 p3 p4 p5 p6 p7 p8 p9 p10 p11 p12 p13 p14 p15
+do
+    (cd $sas_dir && timeout 1000 $translate_py 0 $benchmarks/RectangleTireworld/domain-rectangle-tire.pddl $benchmarks/RectangleTireworld/$problem.pddl > /dev/null && mv output.sas rectangle-$problem.sas)
+    (cd $sas_dir && timeout 1000 $translate_py 0 $benchmarks/BlocksWorldExtended/domain.pddl $benchmarks/BlocksWorldExtended/$problem.pddl > /dev/null && mv output.sas blocksworld-extended-$problem.sas)
+done
+
+./sasbench -s $sas_dir/*.sas -o $benchmarks/results-sas-reader.csv
+
+rm -rf $sas_dir
@@ -15,9 +15,12 @@ int main(int argc, char** argv) {
         "pddl2dfa: a tool to convert PDDL planning domain specifications into DFAs"
     };
 
-    string domain_file, problem_file, out_file = "";
-    bool interactive = false, print_domain = false, save_results = false;
-    int alg_id = -1;
+    string domain_file, problem_file, out_file = "", cache_dir = "", dfa_file = "", import_order_file = "", export_order_file = "";
+    bool interactive = false, print_domain = false, save_results = false, python_grounding = false, prune = false, log_encoding = false;
+    int alg_id = -1, var_order_id = 0, reorder_method_id = 0;
+    unsigned int reorder_threshold = 4004;
+    double reorder_max_growth = 1.2;
+    bool var_groups = false;
 
     CLI::Option* domain_file_opt =
         app.add_option("-d,--domain-file", domain_file, "Path to PDDL domain file") ->
@@ -33,24 +36,85 @@ int main(int argc, char** argv) {
 
     // TODO. Check which information to print in out_file
     CLI::Option* out_file_opt =
-        app.add_option("-o,--out-file", out_file, "Path to output csv file. Stores:\n1. PDDL domain file\n2. PDDL problem file\n3. Run time (secs)\n4. PDDL parsing (secs)\n5. Size of DFA (with --alg==1 only)\n6. Number of actions (with --alg==1 only)\n7. Nodes in BDDs (with --alg==1 only)");
+        app.add_option("-o,--out-file", out_file, "Path to output csv file. Stores:\n1. PDDL domain file\n2. PDDL problem file\n3. Run time (secs)\n4. PDDL parsing (secs)\n5. Size of DFA (with --alg==1 only)\n6. Number of actions (with --alg==1 only)\n7. Nodes in BDDs (with --alg==1 only)\n8. Build time (secs) of action mutex, effects, agent preconditions, environment preconditions, final states and invariants BDDs (with --alg==1 only)");
 
     CLI::Option* interactive_opt =
         app.add_option("-i,--interactive", interactive, "Executes interactively the domain DFA (with --alg==1 only)");
     CLI::Option* print_opt =
         app.add_option("-t,--print-domain", print_domain, "Prints the domain");
 
+    CLI::Option* python_grounding_opt =
+        app.add_option("--python-grounding", python_grounding, "Grounds the PDDL files with the Python translator in submodules rather than in-process");
+
+    CLI::Option* cache_dir_opt =
+        app.add_option("--cache-dir", cache_dir, "Directory where grounded tasks and domain DFAs are cached across runs, keyed by the contents of the PDDL files");
+
+    CLI::Option* prune_opt =
+        app.add_option("--prune", prune, "Drops atoms and actions that are unreachable in the delete relaxation or irrelevant to the goal before constructing the domain DFA");
+
+    CLI::Option* log_encoding_opt =
+        app.add_option("--log-encoding", log_encoding, "Encodes the atoms of each mutex group in logarithmically many state variables (with --alg==1 only)");
+
+    CLI::Option* var_order_opt =
+        app.add_option("--var-order", var_order_id, "Static variable ordering of the domain DFA (with --alg==1 only).\n\t0: Creation order (default)\n\t1: Interaction of fluents and action bits in the grounded actions and invariants\n\t2: FORCE, starting from 1");
+
+    CLI::Option* var_groups_opt =
+        app.add_option("--var-groups", var_groups, "Keeps action bits, reaction bits and the variables of each mutex group adjacent during reordering");
+
+    CLI::Option* reorder_method_opt =
+        app.add_option("--reorder-method", reorder_method_id, "Dynamic variable reordering method.\n\t0: Sifting (default)\n\t1: Symmetric sifting\n\t2: Group sifting\n\t3: Window permutation of 3 variables\n\t4: Simulated annealing");
+
+    CLI::Option* reorder_threshold_opt =
+        app.add_option("--reorder-threshold", reorder_threshold, "Number of BDD nodes that triggers the first dynamic reordering (default 4004)");
+
+    CLI::Option* reorder_max_growth_opt =
+        app.add_option("--reorder-max-growth", reorder_max_growth, "Largest growth of the BDDs allowed while moving a variable during reordering (default 1.2)");
+
+    CLI::Option* import_order_opt =
+        app.add_option("--import-order", import_order_file, "Path to a variable order saved with --export-order for another problem of the same domain, used as initial order of the domain DFA (with --alg==1 only). Unknown names are matched by pattern and predicate");
+
+    CLI::Option* export_order_opt =
+        app.add_option("--export-order", export_order_file, "Path to file where the final variable order of the domain DFA is saved (with --alg==1 only)");
+
+    CLI::Option* dfa_file_opt =
+        app.add_option("--save-dfa", dfa_file, "Path to binary file where the variables and BDDs of the domain DFA and the invariants are saved, to be solved with syft4fond --load-dfa (with --alg==1 only)");
+
     CLI11_PARSE(app, argc, argv);
 
+    Syft::VariableOrderHeuristic var_order;
+    if (var_order_id == 0) var_order = Syft::VariableOrderHeuristic::Creation;
+    else if (var_order_id == 1) var_order = Syft::VariableOrderHeuristic::Interaction;
+    else if (var_order_id == 2) var_order = Syft::VariableOrderHeuristic::Force;
+    else {
+        std::cerr << "Non-existing variable ordering. Termination" << std::endl;
+        return 1;
+    }
+
+    Syft::ReorderingPolicy reordering;
+    if (reorder_method_id == 0) reordering.method = Syft::ReorderingMethod::Sift;
+    else if (reorder_method_id == 1) reordering.method = Syft::ReorderingMethod::SymmetricSift;
+    else if (reorder_method_id == 2) reordering.method = Syft::ReorderingMethod::GroupSift;
+    else if (reorder_method_id == 3) reordering.method = Syft::ReorderingMethod::Window;
+    else if (reorder_method_id == 4) reordering.method = Syft::ReorderingMethod::Annealing;
+    else {
+        std::cerr << "Non-existing reordering method. Termination" << std::endl;
+        return 1;
+    }
+    reordering.first_threshold = reorder_threshold;
+    reordering.max_growth = reorder_max_growth;
+    reordering.variable_groups = var_groups;
+
     std::shared_ptr<Syft::VarMgr> var_mgr = std::make_shared<Syft::VarMgr>();
+    var_mgr->set_reordering_policy(reordering);
 
     Syft::Stopwatch pddl_parsing;
     pddl_parsing.start();
 
     std::cout << "[pddl2dfa] Parsing PDDL domain...";
-    Syft::Domain domain(var_mgr, domain_file, problem_file);  
+    Syft::Domain domain(var_mgr, domain_file, problem_file, python_grounding, cache_dir, prune, log_encoding, var_order, import_order_file);  
     double t_pddl_parsing = pddl_parsing.stop().count() / 1000.0;
     std::cout << "Done [" << t_pddl_parsing << " s]" << std::endl;
+    domain.print_pruning();
 
     if (print_domain) domain.print_domain();
 
@@ -60,17 +124,26 @@ int main(int argc, char** argv) {
 
     if (alg_id == 1) {
         std::cout << "[pddl2dfa] Transforming PDDL to DFA..." << std::flush;;
+        Syft::ReorderingCounter reorderings(var_mgr->cudd_mgr());
         Syft::SymbolicStateDfa domain_dfa = domain.to_symbolic();
         t_pddl2dfa = pddl2dfa.stop().count() / 1000.0;
         std::cout << "Done [" << t_pddl2dfa << " s]" << std::endl;
+        std::cout << "[pddl2dfa] Reorderings: " << reorderings.reorderings() << " [" << reorderings.seconds() << " s]" << std::endl;
         
         if (interactive) domain.interactive(domain_dfa);
+        if (export_order_file != "") domain.save_variable_order(domain_dfa.automaton_id(), export_order_file);
+        if (dfa_file != "") {
+            std::ofstream dfa_stream(dfa_file, std::ofstream::binary);
+            domain.save_dfa(dfa_stream, domain_dfa);
+        }
         if (out_file != "") {
             std::ofstream out_stream(out_file, std::ofstream::app);
             out_stream << domain_file << ","  << problem_file << "," << t_pddl_parsing + t_pddl2dfa << "," << t_pddl_parsing << "," << t_pddl2dfa << "," << domain_dfa.transition_function().size() << "," << domain.get_id_to_action_name().size() << ",";
             std::string bdd_sizes = "";
             for (const auto& bdd : domain_dfa.transition_function()) bdd_sizes += std::to_string(bdd.nodeCount()) + "-";
-            out_stream << bdd_sizes.substr(0, bdd_sizes.size()-1) << std::endl;
+            out_stream << bdd_sizes.substr(0, bdd_sizes.size()-1) << ",";
+            const auto& build_times = domain.get_build_times();
+            out_stream << build_times.mutex << "," << build_times.effects << "," << build_times.agent_pre << "," << build_times.env_pre << "," << build_times.final_states << "," << build_times.invariants << std::endl;
         }
     } else if (alg_id == 0) {
         std::cout << "[pddl2dfa] Transforming PDDL in LTLf and LTLf in DFA..." << std::flush;
@@ -0,0 +1,118 @@
+#include<iostream>
+#include<fstream>
+#include<string>
+#include<vector>
+#include<boost/algorithm/string.hpp>
+#include<CLI/CLI.hpp>
+#include"SasReader.h"
+#include"Stopwatch.h"
+
+using namespace std;
+
+// the getline-based reader Domain used before SasReader, kept as a reference
+Syft::GroundTask parse_sas_getline(const string& sas_file) {
+    Syft::GroundTask task;
+    std::ifstream sas_input_stream(sas_file);
+    std::string line;
+    while (std::getline(sas_input_stream, line)) {
+        if (boost::starts_with(line, "Atom")) {
+            task.atoms.push_back(line.substr(5));
+        } else if (boost::starts_with(line, "begin_state")) {
+            while (line != "end_state") {
+                std::getline(sas_input_stream, line);
+                if (line == "0") task.init.push_back(0);
+                else if (line == "1") task.init.push_back(1);
+            }
+        } else if (boost::starts_with(line, "begin_operator")) {
+            Syft::GroundOperator op;
+            while (line != "end_operator") {
+                std::getline(sas_input_stream, line);
+                if (!((boost::starts_with(line, "  ")) || line == "end_operator")) {
+                    op.name = line;
+                } else if (boost::starts_with(line, "  ")) {
+                    boost::trim(line);
+                    std::vector<std::string> substr_vec;
+                    boost::split(substr_vec, line, boost::is_any_of(" "));
+                    int var = std::stoi(substr_vec[0].substr(1, substr_vec[0].size() - 2));
+                    if (substr_vec.size() == 2) {
+                        op.prevail.push_back(std::make_pair(var, std::stoi(substr_vec[1])));
+                    } else if (substr_vec.size() == 4) {
+                        op.pre_post.push_back(std::make_tuple(var, std::stoi(substr_vec[1]), std::stoi(substr_vec[3])));
+                    }
+                }
+            }
+            task.operators.push_back(op);
+        } else if (boost::starts_with(line, "begin_goal")) {
+            while (line != "end_goal") {
+                std::getline(sas_input_stream, line);
+                std::vector<std::string> substr_vec;
+                boost::split(substr_vec, line, boost::is_any_of(" "));
+                if (substr_vec.size() == 2) task.goal.push_back(std::make_pair(std::stoi(substr_vec[0]), std::stoi(substr_vec[1])));
+            }
+        }
+    }
+    return task;
+}
+
+bool same_task(const Syft::GroundTask& lhs, const Syft::GroundTask& rhs) {
+    if (lhs.atoms != rhs.atoms || lhs.init != rhs.init || lhs.goal != rhs.goal) return false;
+    if (lhs.operators.size() != rhs.operators.size()) return false;
+    for (std::size_t i = 0; i < lhs.operators.size(); ++i) {
+        if (lhs.operators[i].name != rhs.operators[i].name ||
+            lhs.operators[i].prevail != rhs.operators[i].prevail ||
+            lhs.operators[i].pre_post != rhs.operators[i].pre_post) return false;
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+
+    CLI::App app {
+        "sasbench: a micro-benchmark of the readers of translator SAS files"
+    };
+
+    vector<string> sas_files;
+    string out_file = "";
+    int repetitions = 20;
+
+    CLI::Option* sas_files_opt =
+        app.add_option("-s,--sas-files", sas_files, "Paths to SAS files generated by translate.py") ->
+        required() -> check(CLI::ExistingFile);
+
+    CLI::Option* repetitions_opt =
+        app.add_option("-r,--repetitions", repetitions, "Number of times each file is read by each reader");
+
+    CLI::Option* out_file_opt =
+        app.add_option("-o,--out-file", out_file, "Path to output csv file. Stores:\n1. SAS file\n2. Number of operators\n3. getline reader (secs per read)\n4. SasReader (secs per read)");
+
+    CLI11_PARSE(app, argc, argv);
+
+    bool agree = true;
+    for (const auto& sas_file : sas_files) {
+        Syft::Stopwatch getline_time;
+        getline_time.start();
+        Syft::GroundTask getline_task;
+        for (int i = 0; i < repetitions; ++i) getline_task = parse_sas_getline(sas_file);
+        double t_getline = getline_time.stop().count() / 1000.0 / repetitions;
+
+        Syft::Stopwatch streaming_time;
+        streaming_time.start();
+        Syft::GroundTask streaming_task;
+        for (int i = 0; i < repetitions; ++i) streaming_task = Syft::SasReader(sas_file).read();
+        double t_streaming = streaming_time.stop().count() / 1000.0 / repetitions;
+
+        if (!same_task(getline_task, streaming_task)) {
+            std::cerr << "[sasbench] Readers disagree on " << sas_file << std::endl;
+            agree = false;
+        }
+
+        std::cout << "[sasbench] " << sas_file << ": " << streaming_task.operators.size() << " operators, getline "
+            << t_getline << " s, SasReader " << t_streaming << " s" << std::endl;
+
+        if (out_file != "") {
+            std::ofstream out_stream(out_file, std::ofstream::app);
+            out_stream << sas_file << "," << streaming_task.operators.size() << "," << t_getline << "," << t_streaming << std::endl;
+        }
+    }
+    return agree ? 0 : 1;
+}
@@ -6,6 +6,7 @@
 #include<CLI/CLI.hpp>
 #include"VarMgr.h"
 #include"FONDSynthesizer.h"
+#include"PortfolioSynthesizer.h"
 using namespace std;
 
 double sumVec(const std::vector<double>& v) 
@@ -21,44 +22,213 @@ int main(int argc, char** argv) {
         "syft4fond: a tool for reactive synthesis in FOND planning domains"
     };
 
-    string domain_file, problem_file, out_file;
-    bool interactive = false;
+    string domain_file, problem_file, out_file, cache_dir, strategy_file, import_order_file, export_order_file, dfa_file;
+    bool interactive = false, frontier = false, fused = false, forward_reachability = false;
+    bool portfolio = false, python_grounding = false, prune = false, log_encoding = false;
+    int engine_id = 0, var_order_id = 0, reorder_method_id = 0, synthesis_reorderings = -1;
+    unsigned int reorder_threshold = 4004;
+    double reorder_max_growth = 1.2;
+    bool var_groups = false;
+    bool reorder_after_construction = false;
+    std::size_t cluster_threshold = 0;
 
     CLI::Option* domain_file_opt =
-        app.add_option("-d,--domain-file", domain_file, "Path to PDDL domain file") ->
-        required() -> check(CLI::ExistingFile);
+        app.add_option("-d,--domain-file", domain_file, "Path to PDDL domain file. Required without --load-dfa") ->
+        check(CLI::ExistingFile);
 
     CLI::Option* problem_file_opt =
-        app.add_option("-p,--problem-file", problem_file, "Path to PDDL problem file") ->
-        required() -> check(CLI::ExistingFile);
+        app.add_option("-p,--problem-file", problem_file, "Path to PDDL problem file. Required without --load-dfa") ->
+        check(CLI::ExistingFile);
 
     CLI::Option* interactive_opt =
         app.add_option("-i,--interactive", interactive, "Executes the synthesized strategy in interactive mode");
 
+    CLI::Option* engine_opt =
+        app.add_option("-e,--engine", engine_id, "Synthesis engine.\n\t0: Monolithic transition function (default)\n\t1: Transitions partitioned per agent action\n\t2: On-the-fly forward exploration and backward propagation\n\t3: Explicit-state attractor over the grounded actions, without building the domain DFA\n\t4: Automatic selection between 0 and 3 from the domain size, with provisional thresholds");
+
+    CLI::Option* frontier_opt =
+        app.add_option("-f,--frontier", frontier, "Composes the transition function only with the newly won states in each fixpoint iteration (with --engine==0 only)");
+
+    CLI::Option* cluster_threshold_opt =
+        app.add_option("-c,--cluster-threshold", cluster_threshold, "Computes preimages and images through a conjunctive transition relation with clusters of at most the given number of BDD nodes. Adds next-state variables, which reordering also has to move. 0 uses the transition function (default) (with --engine==0,2 only)");
+
+    CLI::Option* fused_opt =
+        app.add_option("-q,--fused-quantification", fused, "Fuses conjunction and quantification in each fixpoint iteration");
+
+    CLI::Option* forward_reachability_opt =
+        app.add_option("-r,--forward-reachability", forward_reachability, "Restricts the game to the states reachable from the initial state");
+
+    CLI::Option* python_grounding_opt =
+        app.add_option("--python-grounding", python_grounding, "Grounds the PDDL files with the Python translator in submodules rather than in-process");
+
+    CLI::Option* cache_dir_opt =
+        app.add_option("--cache-dir", cache_dir, "Directory where grounded tasks and domain DFAs are cached across runs, keyed by the contents of the PDDL files");
+
+    CLI::Option* prune_opt =
+        app.add_option("--prune", prune, "Drops atoms and actions that are unreachable in the delete relaxation or irrelevant to the goal before constructing the domain DFA");
+
+    CLI::Option* log_encoding_opt =
+        app.add_option("--log-encoding", log_encoding, "Encodes the atoms of each mutex group in logarithmically many state variables (with --engine==0,2,4 only)");
+
+    CLI::Option* var_order_opt =
+        app.add_option("--var-order", var_order_id, "Static variable ordering of the domain DFA.\n\t0: Creation order (default)\n\t1: Interaction of fluents and action bits in the grounded actions and invariants\n\t2: FORCE, starting from 1");
+
+    CLI::Option* var_groups_opt =
+        app.add_option("--var-groups", var_groups, "Keeps action bits, reaction bits and the variables of each mutex group adjacent during reordering");
+
+    CLI::Option* reorder_method_opt =
+        app.add_option("--reorder-method", reorder_method_id, "Dynamic variable reordering method.\n\t0: Sifting (default)\n\t1: Symmetric sifting\n\t2: Group sifting\n\t3: Window permutation of 3 variables\n\t4: Simulated annealing");
+
+    CLI::Option* reorder_threshold_opt =
+        app.add_option("--reorder-threshold", reorder_threshold, "Number of BDD nodes that triggers the first dynamic reordering (default 4004)");
+
+    CLI::Option* reorder_max_growth_opt =
+        app.add_option("--reorder-max-growth", reorder_max_growth, "Largest growth of the BDDs allowed while moving a variable during reordering (default 1.2)");
+
+    CLI::Option* reorder_after_construction_opt =
+        app.add_option("--reorder-after-construction", reorder_after_construction, "Reorders the variables to convergence once the domain DFA is built");
+
+    CLI::Option* synthesis_reorderings_opt =
+        app.add_option("--synthesis-reorderings", synthesis_reorderings, "Dynamic reorderings allowed during synthesis. 0 freezes the variable order. Negative values set no limit (default)");
+
+    CLI::Option* import_order_opt =
+        app.add_option("--import-order", import_order_file, "Path to a variable order saved with --export-order for another problem of the same domain, used as initial order of the domain DFA. Unknown names are matched by pattern and predicate");
+
+    CLI::Option* export_order_opt =
+        app.add_option("--export-order", export_order_file, "Path to file where the final variable order of the domain DFA is saved");
+
+    CLI::Option* dfa_file_opt =
+        app.add_option("--load-dfa", dfa_file, "Path to binary file written by pddl2dfa --save-dfa, solved instead of the PDDL files. Ignores the grounding and DFA construction options (with --engine==0,2 only)") ->
+        check(CLI::ExistingFile);
+
+    CLI::Option* strategy_file_opt =
+        app.add_option("--save-strategy", strategy_file, "Path to binary file where the variables and BDDs of the synthesized strategy are saved");
+
+    CLI::Option* portfolio_opt =
+        app.add_option("--portfolio", portfolio, "Runs several engine configurations concurrently and returns the first answer. Ignores the other synthesis options");
+
     CLI::Option* out_file_opt =
-        app.add_option("-o,--out-file", out_file, "Path to output .csv file. Stores:\n1. PDDL domain file\n2. PDDL problem file\n3. Run time (secs)\n4. PDDL parsing (secs)\n5. PDDL2DFA (secs)\n6. Synthesis (secs)\n7. Realizability (0,1)");
+        app.add_option("-o,--out-file", out_file, "Path to output .csv file. Stores:\n1. PDDL domain file\n2. PDDL problem file\n3. Run time (secs)\n4. PDDL parsing (secs)\n5. PDDL2DFA (secs)\n6. Synthesis (secs)\n7. Realizability (0,1)\n8. Fixpoint iterations\n9. Average fixpoint iteration (secs)\n10. Reorderings in PDDL2DFA\n11. Reordering time in PDDL2DFA (secs)\n12. Reorderings in synthesis\n13. Reordering time in synthesis (secs)");
 
     CLI11_PARSE(app, argc, argv);
 
-    std::shared_ptr<Syft::VarMgr> var_mgr = std::make_shared<Syft::VarMgr>();
+    if (dfa_file.empty() && (domain_file.empty() || problem_file.empty())) {
+        std::cerr << "PDDL domain and problem files are required without --load-dfa. Termination" << std::endl;
+        return 1;
+    }
+    if (!dfa_file.empty() && ((engine_id != 0 && engine_id != 2) || portfolio || interactive || !export_order_file.empty())) {
+        std::cerr << "A saved domain DFA is only solved by engines 0 and 2, without portfolio, interactive mode or --export-order. Termination" << std::endl;
+        return 1;
+    }
+    if (log_encoding && (engine_id == 1 || engine_id == 3) && !portfolio) {
+        std::cerr << "Engines 1 and 3 require one state variable per atom and do not support --log-encoding. Termination" << std::endl;
+        return 1;
+    }
+    // the .csv output names the saved DFA in place of the PDDL domain file
+    if (!dfa_file.empty()) domain_file = dfa_file;
+
+    Syft::SynthesisEngine engine;
+    if (engine_id == 0) engine = Syft::SynthesisEngine::Monolithic;
+    else if (engine_id == 1) engine = Syft::SynthesisEngine::Partitioned;
+    else if (engine_id == 2) engine = Syft::SynthesisEngine::OnTheFly;
+    else if (engine_id == 3) engine = Syft::SynthesisEngine::Explicit;
+    else if (engine_id == 4) engine = Syft::SynthesisEngine::Automatic;
+    else {
+        std::cerr << "Non-existing engine. Termination" << std::endl;
+        return 1;
+    }
 
-    Syft::FONDSynthesizer synthesizer(
-        var_mgr,
-        domain_file, 
-        problem_file,
-        interactive); 
+    Syft::VariableOrderHeuristic var_order;
+    if (var_order_id == 0) var_order = Syft::VariableOrderHeuristic::Creation;
+    else if (var_order_id == 1) var_order = Syft::VariableOrderHeuristic::Interaction;
+    else if (var_order_id == 2) var_order = Syft::VariableOrderHeuristic::Force;
+    else {
+        std::cerr << "Non-existing variable ordering. Termination" << std::endl;
+        return 1;
+    }
+
+    Syft::ReorderingPolicy reordering;
+    if (reorder_method_id == 0) reordering.method = Syft::ReorderingMethod::Sift;
+    else if (reorder_method_id == 1) reordering.method = Syft::ReorderingMethod::SymmetricSift;
+    else if (reorder_method_id == 2) reordering.method = Syft::ReorderingMethod::GroupSift;
+    else if (reorder_method_id == 3) reordering.method = Syft::ReorderingMethod::Window;
+    else if (reorder_method_id == 4) reordering.method = Syft::ReorderingMethod::Annealing;
+    else {
+        std::cerr << "Non-existing reordering method. Termination" << std::endl;
+        return 1;
+    }
+    reordering.first_threshold = reorder_threshold;
+    reordering.max_growth = reorder_max_growth;
+    reordering.variable_groups = var_groups;
+    reordering.reorder_after_construction = reorder_after_construction;
+    reordering.synthesis_reorderings = synthesis_reorderings;
 
-    Syft::SynthesisResult result = synthesizer.run();
+    Syft::SynthesisResult result;
+    std::unique_ptr<Syft::FONDSynthesizer> synthesizer;
 
-    auto running_times = synthesizer.get_running_times();
+    if (portfolio) {
+        Syft::PortfolioSynthesizer portfolio_synthesizer(
+            domain_file,
+            problem_file,
+            Syft::PortfolioSynthesizer::default_configurations(),
+            cache_dir,
+            prune);
+
+        result = portfolio_synthesizer.run();
+        std::cout << "[syft4fond] Portfolio winner: " << portfolio_synthesizer.get_winner_name() << std::endl;
+        synthesizer = portfolio_synthesizer.release_winner();
+    } else {
+        std::shared_ptr<Syft::VarMgr> var_mgr = std::make_shared<Syft::VarMgr>();
+        var_mgr->set_reordering_policy(reordering);
+
+        synthesizer = std::make_unique<Syft::FONDSynthesizer>(
+            var_mgr,
+            domain_file, 
+            problem_file,
+            interactive,
+            frontier,
+            engine,
+            cluster_threshold,
+            fused,
+            forward_reachability,
+            python_grounding,
+            cache_dir,
+            prune,
+            log_encoding,
+            var_order,
+            import_order_file,
+            export_order_file,
+            dfa_file); 
+
+        result = synthesizer->run();
+    }
+
+    auto running_times = synthesizer->get_running_times();
+
+    std::size_t iterations = synthesizer->get_fixpoint_iterations();
+    double avg_iteration_time = iterations ? sumVec(synthesizer->get_iteration_times()) / iterations : 0;
+    std::cout << "[syft4fond] Fixpoint iterations: " << iterations << ". Average iteration time [" << avg_iteration_time << " s]" << std::endl;
+
+    auto reorderings = synthesizer->get_reorderings();
+    auto reordering_times = synthesizer->get_reordering_times();
+    std::cout << "[syft4fond] Reorderings in PDDL2DFA: " << reorderings[0] << " [" << reordering_times[0] << " s]. "
+        << "Reorderings in synthesis: " << reorderings[1] << " [" << reordering_times[1] << " s]" << std::endl;
 
     if (result.realizability) {
         std::cout << "[syft4fond] Realizable. Computed strong plan [" << sumVec(running_times) << " s]" << std::endl;
+        if (strategy_file != "") {
+            std::ofstream strategy_stream(strategy_file, std::ofstream::binary);
+            result.transducer->get_var_mgr()->save(strategy_stream);
+            result.transducer->save(strategy_stream);
+        }
         if (out_file != "") {
             std::ofstream out_stream(out_file, std::ofstream::app);
             out_stream << domain_file << "," << problem_file << "," 
             << sumVec(running_times) << "," << running_times[0] << ","
-            << running_times[1] << "," << running_times[2] << "," << 1 << std::endl; 
+            << running_times[1] << "," << running_times[2] << "," << 1 << ","
+            << iterations << "," << avg_iteration_time << ","
+            << reorderings[0] << "," << reordering_times[0] << ","
+            << reorderings[1] << "," << reordering_times[1] << std::endl; 
         }
     } else {
         std::cout << "[syft4fond] Unrealizable. No strong plan exists [" << sumVec(running_times) << " s]" << std::endl;
@@ -66,7 +236,10 @@ int main(int argc, char** argv) {
             std::ofstream out_stream(out_file, std::ofstream::app);
             out_stream << domain_file << "," << problem_file << "," 
             << sumVec(running_times) << "," << running_times[0] << ","
-            << running_times[1] << "," << running_times[2] << "," << 0 << std::endl; 
+            << running_times[1] << "," << running_times[2] << "," << 0 << ","
+            << iterations << "," << avg_iteration_time << ","
+            << reorderings[0] << "," << reordering_times[0] << ","
+            << reorderings[1] << "," << reordering_times[1] << std::endl; 
         }
     }
 
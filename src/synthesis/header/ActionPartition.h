@@ -0,0 +1,50 @@
+#ifndef ACTION_PARTITION_H
+#define ACTION_PARTITION_H
+
+#include <vector>
+
+#include <cuddObj.hh>
+
+namespace Syft {
+
+/**
+ * \brief The transitions of a single agent action in a planning domain.
+ *
+ * Groups all action-reaction pairs of an agent action. Effects are kept as
+ * sparse substitutions on the state variables rather than as part of a
+ * monolithic transition function.
+ */
+struct ActionPartition {
+  // BDD over output variables encoding the agent action
+  CUDD::BDD agent_bdd;
+  // BDD over state variables encoding the precondition of the action
+  CUDD::BDD precondition;
+  // one cube over state variables for each (distinct) outcome of the action.
+  // Positive literals are added fluents, negative literals deleted fluents
+  std::vector<CUDD::BDD> effects;
+  // true iff some reaction code does not correspond to a legal reaction
+  // to the action, i.e. the environment can reach its error state
+  bool illegal_reactions;
+};
+
+/**
+ * \brief The transitions of a single agent action over explicit states.
+ *
+ * Fluents are referred to by their index in the domain. Illegal reactions are
+ * not represented, since they lead to the environment-error state.
+ */
+struct ExplicitActionPartition {
+  // BDD over output variables encoding the agent action
+  CUDD::BDD agent_bdd;
+  // fluents that must (resp. must not) hold for the action to be applicable
+  std::vector<std::size_t> pos_precondition;
+  std::vector<std::size_t> neg_precondition;
+  // for each (distinct) outcome of the action, the added and deleted fluents.
+  // Fluents in both lists are only added
+  std::vector<std::vector<std::size_t>> add_lists;
+  std::vector<std::vector<std::size_t>> delete_lists;
+};
+
+}
+
+#endif // ACTION_PARTITION_H
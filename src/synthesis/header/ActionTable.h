@@ -0,0 +1,175 @@
+/*
+* declares class ActionTable
+* stores the grounded action-reaction pairs of a FOND domain
+* as flat arrays, one row per pair
+*/
+
+#ifndef SYFT_ACTIONTABLE_H
+#define SYFT_ACTIONTABLE_H
+
+#include<string>
+#include<unordered_map>
+#include<vector>
+
+namespace Syft {
+
+    // contiguous range of fluent indices in an ActionTable
+    class FluentRange {
+        const int* begin_;
+        const int* end_;
+
+        public:
+
+            FluentRange(const int* begin, const int* end): begin_(begin), end_(end) {}
+
+            const int* begin() const {
+                return begin_;
+            }
+
+            const int* end() const {
+                return end_;
+            }
+
+            std::size_t size() const {
+                return end_ - begin_;
+            }
+
+            bool contains(int fluent) const;
+    };
+
+    class ActionTable {
+
+        // one list of fluent indices per row, in compressed sparse row form.
+        // Fluents of row r are values_[offsets_[r]] to values_[offsets_[r+1] - 1],
+        // sorted and without duplicates
+        struct FluentLists {
+            std::vector<std::size_t> offsets_ = {0};
+            std::vector<int> values_;
+
+            void push_back(std::vector<int> fluents);
+
+            FluentRange operator[](std::size_t row) const {
+                return FluentRange(values_.data() + offsets_[row], values_.data() + offsets_[row + 1]);
+            }
+        };
+
+        // name of the action-reaction pair of each row
+        std::vector<std::string> names_;
+        std::unordered_map<std::string, std::size_t> name_to_row_;
+
+        // agent action and environment reaction of each row
+        std::vector<int> agent_ids_;
+        std::vector<int> reaction_ids_;
+
+        // names of agent actions and environment reactions by id
+        std::vector<std::string> agent_names_;
+        std::vector<std::string> reaction_names_;
+
+        std::unordered_map<std::string, int> agent_name_to_id_;
+        std::unordered_map<std::string, int> reaction_name_to_id_;
+
+        FluentLists pos_precondition_;
+        FluentLists neg_precondition_;
+        FluentLists add_list_;
+        FluentLists delete_list_;
+
+        static int intern(const std::string& name, std::vector<std::string>& names, std::unordered_map<std::string, int>& name_to_id);
+
+        static void sort_ids(std::vector<int>& ids, std::vector<std::string>& names, std::unordered_map<std::string, int>& name_to_id);
+
+    public:
+
+        /**
+         * \brief appends an action-reaction pair
+         *
+         * \param name name of the pair, i.e. agent_name followed by reaction_name
+         * \param pos_precondition fluents that must hold
+         * \param neg_precondition fluents that must not hold
+         * \param add_list fluents added by the pair
+         * \param delete_list fluents deleted by the pair
+         *
+         * \return false if a pair with the same name is already in the table
+        */
+        bool add_row(
+            const std::string& name,
+            const std::string& agent_name,
+            const std::string& reaction_name,
+            std::vector<int> pos_precondition,
+            std::vector<int> neg_precondition,
+            std::vector<int> add_list,
+            std::vector<int> delete_list
+        );
+
+        /**
+         * \brief renumbers agent actions and environment reactions
+         * in lexicographic order of their names
+         *
+         * Ids are used as binary codes of actions and reactions, hence sorting
+         * makes the encoding depend only on the task, e.g. for DomainCache
+        */
+        void sort_ids();
+
+        std::size_t size() const {
+            return names_.size();
+        }
+
+        std::size_t agent_count() const {
+            return agent_names_.size();
+        }
+
+        std::size_t reaction_count() const {
+            return reaction_names_.size();
+        }
+
+        const std::string& name(std::size_t row) const {
+            return names_[row];
+        }
+
+        int agent_id(std::size_t row) const {
+            return agent_ids_[row];
+        }
+
+        int reaction_id(std::size_t row) const {
+            return reaction_ids_[row];
+        }
+
+        const std::string& agent_name(int agent_id) const {
+            return agent_names_[agent_id];
+        }
+
+        const std::string& reaction_name(int reaction_id) const {
+            return reaction_names_[reaction_id];
+        }
+
+        FluentRange pos_precondition(std::size_t row) const {
+            return pos_precondition_[row];
+        }
+
+        FluentRange neg_precondition(std::size_t row) const {
+            return neg_precondition_[row];
+        }
+
+        FluentRange add_list(std::size_t row) const {
+            return add_list_[row];
+        }
+
+        FluentRange delete_list(std::size_t row) const {
+            return delete_list_[row];
+        }
+
+        /**
+         * \brief copies the rows of some agent actions, renaming fluents
+         *
+         * \param agent_kept whether the rows of each agent action, by id, are copied
+         * \param fluent_map new index of each fluent, or -1 for fluents left out of
+         * all lists of the copied rows
+         *
+         * \return table with ids sorted as by sort_ids
+        */
+        ActionTable restrict(const std::vector<bool>& agent_kept, const std::vector<int>& fluent_map) const;
+
+        void print(std::size_t row) const;
+    };
+}
+
+#endif
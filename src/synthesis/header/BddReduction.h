@@ -0,0 +1,32 @@
+#ifndef BDD_REDUCTION_H
+#define BDD_REDUCTION_H
+
+#include <memory>
+#include <vector>
+
+#include <cuddObj.hh>
+
+namespace Syft {
+
+/**
+ * \brief Conjunction of BDDs, computed as a balanced binary tree.
+ *
+ * Adjacent BDDs are conjoined pairwise until one is left, so that operands
+ * of each operation have similar size and intermediate results stay small.
+ *
+ * \return The constant one of \a mgr if \a bdds is empty.
+ */
+CUDD::BDD conjoin_balanced(const std::shared_ptr<CUDD::Cudd>& mgr,
+                           std::vector<CUDD::BDD> bdds);
+
+/**
+ * \brief Disjunction of BDDs, computed as a balanced binary tree.
+ *
+ * \return The constant zero of \a mgr if \a bdds is empty.
+ */
+CUDD::BDD disjoin_balanced(const std::shared_ptr<CUDD::Cudd>& mgr,
+                           std::vector<CUDD::BDD> bdds);
+
+}
+
+#endif // BDD_REDUCTION_H
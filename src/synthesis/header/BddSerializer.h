@@ -0,0 +1,62 @@
+#ifndef BDD_SERIALIZER_H
+#define BDD_SERIALIZER_H
+
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <cuddObj.hh>
+
+namespace Syft {
+
+/**
+ * \brief Writes and reads BDDs in a compact binary format.
+ *
+ * A stream holds the variable order of the manager, followed by the nodes
+ * shared by all BDDs, children before parents, and the roots. Nodes refer to
+ * variables by index, hence BDDs are read back into a manager whose variables
+ * have the same indices as the one they were written from.
+ */
+class BddSerializer {
+ public:
+
+  /**
+   * \brief Writes BDDs and the variable order of their manager.
+   */
+  static void write(std::ostream& out, const std::shared_ptr<CUDD::Cudd>& mgr,
+                    const std::vector<CUDD::BDD>& bdds);
+
+  /**
+   * \brief Reads BDDs written by \a write.
+   *
+   * Restores the variable order of the written manager before building the
+   * nodes. Throws std::runtime_error if the stream is malformed or if \a mgr
+   * has a different number of variables.
+   */
+  static std::vector<CUDD::BDD> read(std::istream& in,
+                                     const std::shared_ptr<CUDD::Cudd>& mgr);
+
+  /**
+   * \brief Fixed-width primitives shared by the save and load functions of
+   * VarMgr, SymbolicStateDfa and Transducer.
+   */
+  static void write_uint(std::ostream& out, std::uint64_t value);
+  static std::uint64_t read_uint(std::istream& in);
+  static void write_string(std::ostream& out, const std::string& value);
+  static std::string read_string(std::istream& in);
+
+  /**
+   * \brief Writes or checks the 8-character tag at the start of a stream.
+   *
+   * \a read_magic throws std::runtime_error if the tag does not match.
+   */
+  static void write_magic(std::ostream& out, const char* magic);
+  static void read_magic(std::istream& in, const char* magic);
+};
+
+}
+
+#endif // BDD_SERIALIZER_H
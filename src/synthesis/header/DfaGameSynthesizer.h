@@ -5,6 +5,7 @@
 #include "SymbolicStateDfa.h"
 #include "Synthesizer.h"
 #include "Transducer.h"
+#include "TransitionRelation.h"
 
 namespace Syft {
 
@@ -21,8 +22,41 @@ class DfaGameSynthesizer : public Synthesizer<SymbolicStateDfa> {
   std::vector<CUDD::BDD> transition_vector_;
   std::unique_ptr<Quantification> quantify_independent_variables_;
   std::unique_ptr<Quantification> quantify_non_state_variables_;
+  std::unique_ptr<TransitionRelation> transition_relation_;
 
-  CUDD::BDD preimage(const CUDD::BDD& winning_states) const;
+  virtual CUDD::BDD preimage(const CUDD::BDD& winning_states) const;
+
+  /**
+   * \brief Computes the preimage only on the states in \a care_states.
+   *
+   * The transition function is constrained to \a care_states before
+   * composing, so that transitions from other states are never built.
+   *
+   * \return The preimage of \a winning_states conjoined with \a care_states.
+   */
+  CUDD::BDD preimage(const CUDD::BDD& winning_states, const CUDD::BDD& care_states) const;
+
+  /**
+   * \brief Composes a set of states with the transition function.
+   *
+   * Uses the clustered transition relation, with next-state variables
+   * quantified early, if one was built, and CUDD::BDD::VectorCompose otherwise.
+   *
+   * \return A BDD over state, input and output variables that holds iff the
+   *   transition leads into \a states. No variable is quantified.
+   */
+  CUDD::BDD compose(const CUDD::BDD& states) const;
+
+  /**
+   * \brief Computes the set of successors of a set of states.
+   *
+   * Uses the clustered transition relation if one was built, and the range
+   * computation of SymbolicStateDfa::image otherwise.
+   *
+   * \return A BDD over state variables representing all the states reachable
+   *   in one step from \a states, under any input and output.
+   */
+  CUDD::BDD image(const CUDD::BDD& states) const;
 
   CUDD::BDD project_into_states(const CUDD::BDD& winning_moves) const;
   
@@ -40,8 +74,14 @@ class DfaGameSynthesizer : public Synthesizer<SymbolicStateDfa> {
    *
    * \param spec A symbolic-state DFA representing the game's arena.
    * \param starting_player The player that moves first each turn.
+   * \param cluster_threshold If positive, preimages and images are computed
+   *   through a clustered conjunctive transition relation whose clusters have
+   *   at most this many nodes. Building it adds next-state variables to the
+   *   manager for good, which every later reordering has to move. If 0, the
+   *   functional transition function is used and no variable is added.
    */
-  DfaGameSynthesizer(SymbolicStateDfa spec, Player starting_player, Player protagonist_player);
+  DfaGameSynthesizer(SymbolicStateDfa spec, Player starting_player, Player protagonist_player,
+                     std::size_t cluster_threshold = 0);
 
 
   /**
@@ -9,6 +9,7 @@
 
 #include<string>
 #include<fstream>
+#include<iostream>
 #include<boost/algorithm/string/predicate.hpp>
 #include<boost/algorithm/string/classification.hpp>
 #include<boost/algorithm/string/split.hpp>
@@ -17,151 +18,31 @@
 #include<boost/algorithm/string.hpp>
 #include<unordered_set>
 #include<cuddObj.hh>
+#include"ActionPartition.h"
+#include"ActionTable.h"
+#include"DomainCache.h"
+#include"LearnedOrder.h"
+#include"PddlGrounder.h"
+#include"SasReader.h"
 #include"SymbolicStateDfa.h"
+#include"VariableOrdering.h"
 
 // TODO. Add general documentation to all functions in the classes
 namespace Syft {
 
-    class Domain {
-
-        class Action {
-            std::string action_name_;
-            // add_list_ (resp. delete_list_) is a vector of integers
-            // value determines the var (by its index) added (resp. deleted)
-            // pos_precondition_ (resp. neg_preconidtion_) is a vector of integers
-            // value determines var that must (resp. must not) hold (by its index)
-            std::unordered_set<int> pos_precondition_;
-            std::unordered_set<int> neg_precondition_;
-            std::unordered_set<int> add_list_;
-            std::unordered_set<int> delete_list_;
-            // BDDs representing agent action
-            // action_bdd_ represents the whole action-reaction
-            // agent_bdd_ represents the agent action
-            // env_bdd_ represents the env reaction
-            CUDD::BDD action_bdd_;
-            CUDD::BDD agent_bdd_;
-            CUDD::BDD env_bdd_;
-            // std::string representing agent action in LTLf
-            // action_ltlf_ represents the whole action-reaction in LTLf
-            // agent_ltlf_ represent the agent action in LTLf
-            // env_ltlf_ represents the environment reaction in LTLf
-            std::string action_ltlf_;
-            std::string agent_ltlf_;
-            std::string env_ltlf_;
-
-            public:
-
-                bool operator==(const Action& rhs) const {
-                    return action_name_ == rhs.action_name_;
-                }
-
-                Action(
-                    std::string action_name,
-                    std::unordered_set<int> pos_precondition,
-                    std::unordered_set<int> neg_precondition,
-                    std::unordered_set<int> add_list,
-                    std::unordered_set<int> delete_list
-                ) : action_name_(action_name),
-                    pos_precondition_(pos_precondition),
-                    neg_precondition_(neg_precondition),
-                    add_list_(add_list),
-                    delete_list_(delete_list) {} 
-
-                std::string get_action_name() const {
-                    return action_name_;
-                }
-
-                CUDD::BDD get_action_bdd() const {
-                    return action_bdd_;
-                }
-
-                CUDD::BDD get_agent_bdd() const {
-                    return agent_bdd_;
-                }
-
-                CUDD::BDD get_env_bdd() const {
-                    return env_bdd_;
-                }
-
-                std::string get_action_ltlf() const {
-                    return action_ltlf_;
-                }
-
-                std::string get_agent_ltlf() const {
-                    return agent_ltlf_;
-                }
-
-                std::string get_env_ltlf() const {
-                    return env_ltlf_;
-                }
-
-                std::unordered_set<int> get_add_list() const {
-                    return add_list_;
-                }
-
-                std::unordered_set<int> get_del_list() const {
-                    return delete_list_;
-                }
-
-                std::unordered_set<int> get_pos_pre() const {
-                    return pos_precondition_;
-                }
-
-                std::unordered_set<int> get_neg_pre() const {
-                    return neg_precondition_;
-                }
-
-                // void set_action_bin(const std::vector<int>& agent_bin) {
-                    // agent_bin_ = agent_bin; 
-                // }
-
-                // void set_env_bin(const std::vector<int>& env_bin) {
-                    // env_bin_ = env_bin;
-                // }
-
-                void set_action_bdd(const CUDD::BDD& bdd) {
-                    action_bdd_ = bdd;
-                }
-
-                void set_agent_bdd(const CUDD::BDD& agent_bdd) {
-                    agent_bdd_ = agent_bdd;
-                }
-
-                void set_env_bdd(const CUDD::BDD& env_bdd) {
-                    env_bdd_ = env_bdd;
-                }
-
-                void set_action_ltlf(const std::string& ltlf) {
-                    action_ltlf_ = ltlf;
-                }
-
-                void set_agent_ltlf(const std::string& agent_ltlf) {
-                    agent_ltlf_ = agent_ltlf;
-                }
-
-                void set_env_ltlf(const std::string& env_ltlf) {
-                    env_ltlf_ = env_ltlf;
-                }
+    /**
+     * \brief a domain DFA read back from a file written by Domain::save_dfa
+    */
+    struct SavedDomainDfa {
+        std::shared_ptr<VarMgr> var_mgr;
+        SymbolicStateDfa dfa;
+        // number of state variables encoding atoms, the agent- and
+        // environment-error variables follow them
+        std::size_t state_var_count;
+        CUDD::BDD invariants;
+    };
 
-                void print() const {
-                    std::cout << "ACTION NAME: " << action_name_ << std::endl;
-                    // std::cout << "AGENT VARS: ";
-                    // for (const auto& i : agent_bin_) std::cout << i;
-                    // std::cout << std::endl;
-                    // std::cout << "ENV VARS: ";
-                    // for (const auto& i : env_bin_) std::cout << i;
-                    // std::cout << std::endl;
-                    std::string precondition = "";
-                    for (const auto& i : pos_precondition_) precondition += std::to_string(i) + ", "; 
-                    for (const auto& i : neg_precondition_) precondition += std::to_string(i) + ", ";
-                    std::cout << "PRECONDITION {" + precondition.substr(0, precondition.size() - 2) + "}" << std::endl; 
-                    std::string add_list = "", delete_list = "";
-                    for (const auto& i : add_list_) add_list += std::to_string(i) + ", ";
-                    for (const auto& i : delete_list_) delete_list += std::to_string(i) + ", ";
-                    std::cout << "ADD-LIST {" + add_list.substr(0, add_list.size() - 2) + "}" << std::endl;
-                    std::cout << "DELETE-LIST {" + delete_list.substr(0, delete_list.size() - 2) + "}" << std::endl;
-                }
-        };
+    class Domain {
 
         class Invariant {
             // class to describe invariants. At most
@@ -209,22 +90,28 @@ namespace Syft {
             }
         };
 
-        struct ActionHash{
-            size_t operator()(const Action& a) const {
-                std::hash<std::string> hasher;
-                size_t seed = 0;
-                seed = hasher(a.get_action_name()) + 0x9e3779b9 + (seed<<6) + (seed>>2);
-                return seed;
-            }
+        // seconds spent by to_symbolic in each BDD builder,
+        // all 0 if the domain DFA was read from the cache
+        struct BuildTimes {
+            double mutex = 0;
+            double effects = 0;
+            double agent_pre = 0;
+            double env_pre = 0;
+            double final_states = 0;
+            double invariants = 0;
         };
 
-        struct BDDHash{
-            std::size_t operator()(const CUDD::BDD& bdd) const {
-                std::hash<int> hasher;
-                std::size_t seed = 0;
-                seed = hasher(bdd.NodeReadIndex()) + 0x9e37463a + (seed<<8) + (seed>>1);;
-                return seed;
-            }
+        // atoms and action-reaction pairs compiled out as rigid,
+        // and before pruning and removed by it
+        struct PruningReport {
+            std::size_t rigid_vars = 0;
+            std::size_t inapplicable_actions = 0;
+            std::size_t vars = 0;
+            std::size_t constant_vars = 0;
+            std::size_t irrelevant_vars = 0;
+            std::size_t actions = 0;
+            std::size_t unreachable_actions = 0;
+            std::size_t irrelevant_actions = 0;
         };
 
         // data members go here
@@ -244,30 +131,89 @@ namespace Syft {
             std::unordered_set<int> pos_goal_list_;
             std::unordered_set<int> neg_goal_list_;
 
-            std::unordered_set<Action, ActionHash> actions_;
+            // one row per grounded action-reaction pair
+            ActionTable actions_;
+
+            // BDDs (resp. LTLf formulas) encoding agent actions and
+            // environment reactions, indexed by their id in actions_
+            std::vector<CUDD::BDD> agent_bdds_;
+            std::vector<CUDD::BDD> reaction_bdds_;
+            std::vector<std::string> agent_ltlfs_;
+            std::vector<std::string> reaction_ltlfs_;
 
             std::vector<std::string> action_vars_;
             std::vector<std::string> reaction_vars_;
 
+            // at least one agent action and environment reaction
+            // holds, as returned by get_action_reaction_vars
+            std::pair<CUDD::BDD, CUDD::BDD> mutex_axioms_;
+
             std::map<int, std::string> id_to_action_name_;
             std::map<int, std::string> id_to_reaction_name_;
 
             std::unordered_set<Invariant, InvariantHash> invariants_;
 
             CUDD::BDD invariants_bdd_;
+
+            // atoms are partitioned in groups, each group is encoded in binary
+            // by its own state variables. Code 0 of a group means that no atom
+            // holds, unless exactly one atom always holds. Without log_encoding_
+            // each atom is a group, with code 1, and state variable i is atom i
+            bool log_encoding_;
+            std::vector<std::vector<int>> state_groups_;
+            std::vector<bool> exactly_one_;
+            std::vector<std::size_t> group_offsets_;
+            std::vector<int> atom_groups_;
+            std::vector<int> atom_codes_;
+            std::size_t state_var_count_ = 0;
+
+            // BDD over state variables that holds iff atom i holds
+            std::vector<CUDD::BDD> atom_bdds_;
+
+            VariableOrderHeuristic var_order_;
+
+            LearnedOrder learned_order_;
+
+            std::shared_ptr<DomainCache> cache_;
+
+            PruningReport pruning_;
+
+            BuildTimes build_times_;
         public: 
             /**
              * \brief construct FOND domain from PDDL domain and problem file
              * 
              * \param domain_file path to PDDL domain file
              * \param problem_file path to PDDL problem file
+             * \param python_grounding whether to ground with the Python translator
+             * in submodules rather than in-process. The translator is also used
+             * when the PDDL files are not supported by PddlGrounder
+             * \param cache_dir directory of DomainCache. If not empty, the
+             * grounded task and the domain DFA are read from the cache if
+             * present, and stored in it otherwise
+             * \param prune whether to drop atoms and agent actions that are
+             * unreachable in the delete relaxation or irrelevant to the goal
+             * \param log_encoding whether to_symbolic encodes the atoms of each
+             * mutex group in logarithmically many state variables. Not supported
+             * by get_action_partitions and get_explicit_action_partitions
+             * \param var_order heuristic by which to_symbolic orders the state,
+             * action and reaction variables before any BDD is built
+             * \param order_file file written by save_variable_order for another
+             * problem, whose order to_symbolic follows instead of var_order
+             * wherever variable names match
              * 
              * \return Domain object representing FOND domain
             */
             Domain(
                 std::shared_ptr<Syft::VarMgr> var_mgr,
                 const std::string& domain_file,
-                const std::string& problem_file
+                const std::string& problem_file,
+                bool python_grounding = false,
+                const std::string& cache_dir = "",
+                bool prune = false,
+                bool log_encoding = false,
+                VariableOrderHeuristic var_order = VariableOrderHeuristic::Creation,
+                const std::string& order_file = ""
             );
 
             std::vector<std::string> get_vars() const {
@@ -302,24 +248,166 @@ namespace Syft {
                 return invariants_bdd_;
             }
 
-            SymbolicStateDfa to_symbolic();
+            std::unordered_set<int> get_pos_goal() const {
+                return pos_goal_list_;
+            }
+
+            // ids of the fluents false in the goal, negated
+            std::unordered_set<int> get_neg_goal() const {
+                return neg_goal_list_;
+            }
+
+            /**
+             * \brief creates the state variables of the domain DFA and the action
+             * and reaction variables, and encodes actions and reactions over them
+             *
+             * Builds no BDD over state variables, hence engines working on the
+             * action table can skip to_symbolic. Called by to_symbolic
+             *
+             * \return ID of the domain DFA in var_mgr
+            */
+            std::size_t create_variables();
+
+            /**
+             * \brief initial state of the domain DFA, with error variables false
+            */
+            std::vector<int> get_dfa_initial_state() const;
+
+            /**
+             * \brief builds the domain DFA, its final states and the invariants
+             *
+             * \param build_transition_function whether to build the transition
+             * function, together with the action and reaction preconditions.
+             * Engines working on get_action_partitions do not need it, and the
+             * returned DFA has an empty transition function then
+            */
+            SymbolicStateDfa to_symbolic(bool build_transition_function = true);
 
             SymbolicStateDfa to_ltlf_and_symbolic();
 
+            /**
+             * \brief partitions the transitions of the domain per agent action
+             *
+             * \param automaton_id ID of the domain DFA returned by to_symbolic
+             *
+             * \return one ActionPartition for each agent action
+            */
+            std::vector<ActionPartition> get_action_partitions(std::size_t automaton_id) const;
+
+            /**
+             * \brief partitions the transitions of the domain per agent action over explicit states
+             *
+             * \return one ExplicitActionPartition for each agent action.
+             * Requires agent actions to be encoded, i.e. create_variables to be called
+            */
+            std::vector<ExplicitActionPartition> get_explicit_action_partitions() const;
+
+            std::size_t get_action_count() const {
+                return actions_.size();
+            }
+
+            /**
+             * \brief number of state variables encoding atoms in the domain DFA
+             *
+             * The agent- and environment-error variables follow them.
+             * Requires create_variables to be called
+            */
+            std::size_t get_state_var_count() const {
+                return state_var_count_;
+            }
+
+            /**
+             * \brief atoms holding in a state of the domain DFA returned by to_symbolic
+            */
+            std::vector<std::string> get_true_atoms(const std::vector<int>& state) const;
+
             void print_domain() const;
 
+            /**
+             * \brief prints how many atoms and action-reaction pairs were compiled
+             * out as rigid, and pruned if the domain was constructed with prune
+            */
+            void print_pruning(std::ostream& out = std::cout) const;
+
+            const BuildTimes& get_build_times() const {
+                return build_times_;
+            }
+
             void interactive(const SymbolicStateDfa& domain_dfa) const;
 
+            /**
+             * \brief writes the current order of the variables of the domain DFA
+             * created by create_variables, by name, e.g. for order_file of other problems
+             *
+             * Atoms are named as in get_vars. Bits of log-encoded groups are named
+             * after the first atom of the group, agent actions and environment
+             * reactions after their bits
+            */
+            void save_variable_order(std::size_t automaton_id, const std::string& file) const;
+
+            /**
+             * \brief saves the domain DFA with what symbolic synthesis needs from the domain
+             *
+             * Writes the variables, the domain DFA, the number of state variables
+             * encoding atoms and the invariants, so that the DFA can be solved
+             * without the PDDL files. The grounded actions and atom names are not
+             * saved, hence neither the partitioned and explicit engines nor the
+             * interactive mode can use the file
+            */
+            void save_dfa(std::ostream& out, const SymbolicStateDfa& domain_dfa) const;
+
+            /**
+             * \brief reads a domain DFA written by save_dfa into a new VarMgr
+            */
+            static SavedDomainDfa load_dfa(std::istream& in);
+
         private:
-            std::size_t get_bits(const std::unordered_set<std::string>& set) const;
+            std::size_t get_bits(std::size_t count) const;
 
             std::vector<int> to_bits(int i, std::size_t size) const;
 
-            void parse_sas();
+            GroundTask ground_with_python(const std::string& domain_file, const std::string& problem_file) const;
+
+            void load_task(const GroundTask& task);
+
+            void compile_rigid_atoms();
+
+            void group_state_variables();
+
+            std::vector<int> get_initial_state_vars() const;
+
+            CUDD::BDD get_valid_codes(std::size_t automaton_id) const;
+
+            // moves the variables of the domain DFA, within the levels they
+            // occupy, to the order computed by var_order_ from the constraints
+            // of the grounded task
+            void apply_variable_order(std::size_t automaton_id) const;
+
+            // state variables, then action bits, then reaction bits
+            std::vector<CUDD::BDD> get_domain_variables(std::size_t automaton_id) const;
+
+            // names of the variables of get_domain_variables
+            std::vector<std::string> get_domain_variable_names() const;
+
+            // blocks of variables, by position in get_domain_variables, that
+            // reordering moves as units: action bits, reaction bits and the
+            // variables of each mutex group
+            std::vector<std::vector<int>> get_variable_blocks() const;
+
+            // registers the blocks of get_variable_blocks as variable groups
+            void group_variables(std::size_t automaton_id) const;
+
+            // atoms of mutex invariants, partitioned greedily into groups
+            // of at least two atoms
+            std::vector<std::vector<int>> get_mutex_groups() const;
+
+            void prune_task();
 
-            std::pair<std::unordered_set<std::string>, std::unordered_set<std::string>> get_action_reaction_names() const;
+            // keeps the rows of agent actions in agent_kept and renames atoms
+            // by fluent_map. Atoms mapped to -1 are left out of the domain
+            void restrict_task(const std::vector<bool>& agent_kept, const std::vector<int>& fluent_map);
 
-            std::pair<std::string, std::string> get_ltlf_action_reaction_vars(const std::unordered_set<std::string>& action_names, const std::unordered_set<std::string>& reaction_names);
+            std::pair<std::string, std::string> get_ltlf_action_reaction_vars();
 
             std::string get_ltlf_init() const;
 
@@ -331,9 +419,9 @@ namespace Syft {
             
             std::string get_ltlf_env_pre() const;
 
-            std::pair<CUDD::BDD, CUDD::BDD> get_action_reaction_vars(const std::unordered_set<std::string>& action_names, const std::unordered_set<std::string>& reaction_names);
+            std::pair<CUDD::BDD, CUDD::BDD> get_action_reaction_vars();
 
-            std::vector<CUDD::BDD> get_transition_function(std::size_t automaton_id, const CUDD::BDD& agent_mutex, const CUDD::BDD& env_mutex) const;
+            std::vector<CUDD::BDD> get_transition_function(std::size_t automaton_id, const CUDD::BDD& agent_mutex, const CUDD::BDD& env_mutex, const CUDD::BDD& agent_pre, const CUDD::BDD& env_pre) const;
 
             CUDD::BDD get_final_states(std::size_t automaton_id) const;
 
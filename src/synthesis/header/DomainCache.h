@@ -0,0 +1,76 @@
+/*
+* declares class DomainCache
+* stores grounded tasks and domain DFAs on disk, keyed by the PDDL files
+*/
+
+#ifndef SYFT_DOMAINCACHE_H
+#define SYFT_DOMAINCACHE_H
+
+#include<cstdint>
+#include<filesystem>
+#include<memory>
+#include<string>
+#include<vector>
+#include<cuddObj.hh>
+#include"PddlGrounder.h"
+
+namespace Syft {
+
+    class DomainCache {
+
+        // directory of the entry of the PDDL files and options
+        std::filesystem::path entry_;
+
+        static std::uint64_t hash(const std::string& data, std::uint64_t seed);
+
+        static std::string read_file(const std::string& file);
+
+        // writes to a unique temporary file first, so that concurrent runs
+        // and threads never read a partially written entry
+        void store(const std::string& name, const std::string& data) const;
+
+    public:
+
+        /**
+         * \brief opens the cache entry of a PDDL domain and problem file
+         *
+         * \param cache_dir directory holding all cache entries
+         * \param domain_file path to PDDL domain file
+         * \param problem_file path to PDDL problem file
+         * \param options options the cached data depends on
+        */
+        DomainCache(
+            const std::string& cache_dir,
+            const std::string& domain_file,
+            const std::string& problem_file,
+            const std::string& options
+        );
+
+        /**
+         * \brief reads the grounded task of the entry
+         *
+         * \return false if the entry has no grounded task
+        */
+        bool load_task(GroundTask& task) const;
+
+        void store_task(const GroundTask& task) const;
+
+        /**
+         * \brief reads the BDDs of the domain DFA of the entry
+         *
+         * The variables of mgr must be created as when the BDDs were stored.
+         * Restores the variable order of the stored BDDs
+         *
+         * \return false if the entry has no BDDs or they do not fit mgr
+        */
+        bool load_bdds(const std::shared_ptr<CUDD::Cudd>& mgr, std::vector<CUDD::BDD>& bdds) const;
+
+        void store_bdds(const std::shared_ptr<CUDD::Cudd>& mgr, const std::vector<CUDD::BDD>& bdds) const;
+
+        std::string get_entry() const {
+            return entry_.string();
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,128 @@
+#ifndef EXPLICIT_REACHABILITY_SYNTHESIZER_H
+#define EXPLICIT_REACHABILITY_SYNTHESIZER_H
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "ActionPartition.h"
+#include "Synthesizer.h"
+#include "VarMgr.h"
+
+namespace Syft {
+
+/**
+ * \brief An explicit-state synthesizer for the reachability game of a FOND planning domain.
+ *
+ * Explores the states reachable from the initial state, packed as bitsets
+ * over the fluents, and computes the strong attractor of the goal states with
+ * a worklist. Each action of each state keeps a counter of the outcomes not
+ * yet known to be winning. Intended for small domains, where the symbolic
+ * fixpoint costs more than the game itself. Assumes that the agent moves
+ * first and is the protagonist, as in PartitionedReachabilitySynthesizer.
+ *
+ * Works on the grounded actions only, hence no BDD over the state variables
+ * of the domain DFA is needed except for the strategy. Explored states are
+ * reachable, hence they satisfy the invariants of the domain.
+ */
+class ExplicitReachabilitySynthesizer {
+ private:
+
+  using PackedState = std::vector<std::uint64_t>;
+
+  struct PackedStateHash {
+    std::size_t operator()(const PackedState& state) const {
+      std::hash<std::uint64_t> hasher;
+      std::size_t seed = 0;
+      for (std::uint64_t word : state) {
+        seed ^= hasher(word) + 0x9e3779b9 + (seed<<6) + (seed>>2);
+      }
+      return seed;
+    }
+  };
+
+  struct PackedAction {
+    CUDD::BDD agent_bdd;
+    PackedState pos_precondition;
+    PackedState neg_precondition;
+    std::vector<PackedState> add_masks;
+    std::vector<PackedState> delete_masks;
+  };
+
+  std::shared_ptr<VarMgr> var_mgr_;
+  std::size_t automaton_id_;
+  std::vector<int> initial_state_;
+  std::size_t fluent_count_;
+  std::vector<PackedAction> actions_;
+  PackedState pos_goal_;
+  PackedState neg_goal_;
+
+  CUDD::BDD winning_states_;
+  CUDD::BDD winning_moves_;
+  std::size_t iterations_;
+  std::vector<double> iteration_times_;
+
+  PackedState pack(const std::vector<std::size_t>& fluents) const;
+
+  PackedState pack_state(const std::vector<int>& state_vector) const;
+
+  std::vector<int> unpack_state(const PackedState& state) const;
+
+  bool is_goal(const PackedState& state) const;
+
+ public:
+
+  /**
+   * \brief Construct a synthesizer for the given reachability game.
+   *
+   * \param var_mgr The manager holding the variables of the domain DFA.
+   * \param automaton_id The ID of the domain DFA, as returned by
+   *   Domain::create_variables.
+   * \param initial_state The initial state of the domain DFA.
+   * \param pos_goal The fluents that must hold in goal states.
+   * \param neg_goal The fluents that must not hold in goal states, negated as
+   *   in Domain::get_neg_goal.
+   * \param partitions The transitions of the domain, one partition per agent action.
+   * \param fluent_count The number of fluents of the domain.
+   */
+  ExplicitReachabilitySynthesizer(std::shared_ptr<VarMgr> var_mgr,
+                                  std::size_t automaton_id,
+                                  std::vector<int> initial_state,
+                                  const std::unordered_set<int>& pos_goal,
+                                  const std::unordered_set<int>& neg_goal,
+                                  const std::vector<ExplicitActionPartition>& partitions,
+                                  std::size_t fluent_count);
+
+  /**
+   * \brief Solves the reachability game.
+   *
+   * Each fixpoint iteration processes one layer of the attractor worklist.
+   *
+   * \return The result consists of
+   * realizability
+   * the explored agent winning states
+   * a transducer representing a winning strategy. The transducer has no
+   * transition function, since the domain DFA is not built.
+   */
+  SynthesisResult run();
+
+  CUDD::BDD get_winning_states() const;
+
+  CUDD::BDD get_winning_moves() const;
+
+  /**
+   * \brief Returns the number of fixpoint iterations of the last run.
+   */
+  std::size_t get_iterations() const;
+
+  /**
+   * \brief Returns the running time (secs) of each fixpoint iteration of the last run.
+   */
+  std::vector<double> get_iteration_times() const;
+};
+
+}
+
+#endif // EXPLICIT_REACHABILITY_SYNTHESIZER_H
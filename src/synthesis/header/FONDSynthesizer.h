@@ -6,6 +6,7 @@
 #ifndef SYFT_FONDSYNTHESIZER_H
 #define SYFT_FONDSYNTHESIZER_H
 
+#include<iostream>
 #include<memory>
 #include<string>
 #include<stdlib.h>
@@ -16,11 +17,34 @@
 #include"ExplicitStateDfa.h"
 #include"SymbolicStateDfa.h"
 #include"ReachabilitySynthesizer.h"
+#include"PartitionedReachabilitySynthesizer.h"
+#include"OnTheFlySynthesizer.h"
+#include"ExplicitReachabilitySynthesizer.h"
 #include"Domain.h"
 #include"Stopwatch.h"
 
 namespace Syft {
 
+    /**
+     * \brief engines solving the reachability game of the domain
+     *
+     * Monolithic composes the monolithic transition function of the domain DFA.
+     * Partitioned computes the strong preimage per agent action.
+     * OnTheFly explores the domain forward from the initial state and
+     * propagates winning states backward through the explored states only.
+     * Explicit computes the attractor over explicitly enumerated states,
+     * from the grounded actions, without building the domain DFA.
+     * Automatic picks Explicit for small domains and Monolithic otherwise.
+     * Its thresholds are provisional, they have not been benchmarked yet
+    */
+    enum class SynthesisEngine {
+        Monolithic,
+        Partitioned,
+        OnTheFly,
+        Explicit,
+        Automatic
+    };
+
     class FONDSynthesizer {
 
         protected:
@@ -30,19 +54,70 @@ namespace Syft {
             std::string problem_file_;
 
             bool interactive_;
+            bool frontier_;
+            SynthesisEngine engine_;
+            std::size_t cluster_threshold_;
+            bool fused_;
+            bool forward_reachability_;
+            bool python_grounding_;
+            std::string cache_dir_;
+            bool prune_;
+            bool log_encoding_;
+            VariableOrderHeuristic var_order_;
+            std::string import_order_file_;
+            std::string export_order_file_;
+            // domain DFA saved by Domain::save_dfa, solved instead of the PDDL files
+            std::string dfa_file_;
 
             std::vector<double> running_times_;
 
+            // reorderings and seconds spent in them during the
+            // construction of the domain DFA and during synthesis
+            std::vector<std::size_t> reorderings_;
+            std::vector<double> reordering_times_;
+
+            // largest domains, in number of fluents and grounded action-reaction
+            // pairs, for which the automatic engine selection picks Explicit.
+            // Provisional, to be set from benchmarks of both engines
+            static constexpr std::size_t explicit_max_fluents_ = 48;
+            static constexpr std::size_t explicit_max_actions_ = 256;
+
+            std::size_t fixpoint_iterations_;
+            std::vector<double> iteration_times_;
+
+            // progress lines of run
+            std::ostream* log_;
+
         public:
 
             FONDSynthesizer(std::shared_ptr<Syft::VarMgr> var_mgr,
                 const std::string& domain_file,
                 const std::string& problem_file,
-                bool interactive
+                bool interactive,
+                bool frontier = false,
+                SynthesisEngine engine = SynthesisEngine::Monolithic,
+                std::size_t cluster_threshold = 0,
+                bool fused = false,
+                bool forward_reachability = false,
+                bool python_grounding = false,
+                const std::string& cache_dir = "",
+                bool prune = false,
+                bool log_encoding = false,
+                VariableOrderHeuristic var_order = VariableOrderHeuristic::Creation,
+                const std::string& import_order_file = "",
+                const std::string& export_order_file = "",
+                const std::string& dfa_file = ""
             );
 
             virtual Syft::SynthesisResult run() final;
 
+            /**
+             * \brief writes the progress lines of run to log instead of std::cout
+             *
+             * Interactive debugging still uses std::cout
+            */
+            void set_log(std::ostream& log) {log_ = &log;}
+
             void interactive(
                 const Domain& domain,
                 const SymbolicStateDfa& domain_dfa,
@@ -50,7 +125,28 @@ namespace Syft {
 
             std::vector<double> get_running_times() const {return running_times_;}
 
+            std::vector<std::size_t> get_reorderings() const {return reorderings_;}
+
+            std::vector<double> get_reordering_times() const {return reordering_times_;}
+
+            std::size_t get_fixpoint_iterations() const {return fixpoint_iterations_;}
+
+            std::vector<double> get_iteration_times() const {return iteration_times_;}
+
         private:
+            // Explicit engine, which only creates the variables of the
+            // domain DFA, for the strategy, instead of building it
+            SynthesisResult run_explicit(Domain& domain);
+
+            // Monolithic and on-the-fly engines on a domain DFA saved by
+            // Domain::save_dfa, without parsing the PDDL files
+            SynthesisResult run_loaded();
+
+            // solves the reachability game of the domain DFA and records the
+            // synthesis times. domain is only needed by the partitioned engine
+            SynthesisResult synthesize(const SymbolicStateDfa& domain_dfa, std::size_t state_var_count,
+                const CUDD::BDD& invariant_bdd, SynthesisEngine engine, const Domain* domain);
+
             std::vector<int> to_bits(int i, std::size_t size) const;
 
             int to_int(const std::vector<int>& bits) const;
@@ -0,0 +1,70 @@
+/*
+* declares class LearnedOrder
+* variable order of a solved problem, reused as initial
+* order for other problems of the same domain
+*/
+
+#ifndef SYFT_LEARNEDORDER_H
+#define SYFT_LEARNEDORDER_H
+
+#include<string>
+#include<vector>
+
+namespace Syft {
+
+    class LearnedOrder {
+
+        // names of variables, from the top of the order to the bottom
+        std::vector<std::string> names_;
+
+        // name with every run of digits replaced by '#', e.g. atom_on_b#_b#
+        static std::string pattern(const std::string& name);
+
+        // tokens of a name, separated by '_', that contain no digit, e.g. atom_on
+        static std::string predicate(const std::string& name);
+
+        // runs of digits of a name, in order, e.g. {1, 2} for atom_on_b1_b2
+        static std::vector<long> numbers(const std::string& name);
+
+    public:
+
+        LearnedOrder() = default;
+
+        explicit LearnedOrder(std::vector<std::string> names): names_(std::move(names)) {}
+
+        /**
+         * \brief reads an order written by save, one name per line
+         *
+         * Throws std::runtime_error if the file cannot be read
+        */
+        static LearnedOrder load(const std::string& file);
+
+        void save(const std::string& file) const;
+
+        bool empty() const {
+            return names_.empty();
+        }
+
+        const std::vector<std::string>& names() const {
+            return names_;
+        }
+
+        /**
+         * \brief orders variables of another problem as in the learned order
+         *
+         * Each variable gets the relative position in the learned order of the
+         * variable with the same name. Variables whose name is not learned are
+         * matched by pattern and then by predicate. Within a pattern or
+         * predicate, they are spread over the positions of the learned
+         * variables of the same key, in the order of the objects they mention.
+         * Variables with no match keep their relative position in fallback.
+         *
+         * \param names name of each variable
+         * \param fallback order of the variables to fall back to
+         * \return variables from the top of the order to the bottom
+        */
+        std::vector<int> order(const std::vector<std::string>& names, const std::vector<int>& fallback) const;
+    };
+}
+
+#endif
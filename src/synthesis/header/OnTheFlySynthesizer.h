@@ -0,0 +1,59 @@
+#ifndef ON_THE_FLY_SYNTHESIZER_H
+#define ON_THE_FLY_SYNTHESIZER_H
+
+#include "ReachabilitySynthesizer.h"
+
+namespace Syft {
+
+/**
+ * \brief An on-the-fly synthesizer for a reachability game given as a symbolic-state DFA.
+ *
+ * In the style of OTFUR, explores the game forward from the initial state one
+ * layer at a time, and propagates winning states backward only through the
+ * states explored so far. Winning, goal and agent-error states are not
+ * expanded. Stops as
+ * soon as the initial state is winning, or when no new state can be explored.
+ */
+class OnTheFlySynthesizer : public ReachabilitySynthesizer {
+ private:
+
+  CUDD::BDD agent_error_var_;
+
+ public:
+
+  /**
+   * \brief Construct a synthesizer for the given reachability game.
+   *
+   * \param spec A symbolic-state DFA representing the reachability game.
+   * \param starting_player The player that moves first each turn.
+   * \param goal_states The set of states that the agent must reach to win.
+   * \param state_space The set of states the game is restricted to.
+   * \param agent_error_var The state variable of the agent-error state, which
+   *   is never winning.
+   * \param cluster_threshold If positive, the maximum size of the clusters of
+   *   the conjunctive transition relation used for preimages and forward
+   *   exploration. If 0, the transition function is used for both.
+   */
+  OnTheFlySynthesizer(SymbolicStateDfa spec, Player starting_player, Player protagonist_player,
+                      CUDD::BDD goal_states, CUDD::BDD state_space,
+                      CUDD::BDD agent_error_var,
+                      std::size_t cluster_threshold = 0);
+
+  /**
+   * \brief Solves the reachability game.
+   *
+   * Each fixpoint iteration explores a new layer of states and propagates the
+   * winning states backward through the explored states. Preimages are only
+   * computed on the explored states not yet winning.
+   *
+   * \return The result consists of
+   * realizability
+   * a set of agent winning states
+   * a transducer representing a winning strategy or nullptr if the game is unrealizable.
+   */
+  virtual SynthesisResult run() final;
+};
+
+}
+
+#endif // ON_THE_FLY_SYNTHESIZER_H
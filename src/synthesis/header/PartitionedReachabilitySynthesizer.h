@@ -0,0 +1,61 @@
+#ifndef PARTITIONED_REACHABILITY_SYNTHESIZER_H
+#define PARTITIONED_REACHABILITY_SYNTHESIZER_H
+
+#include "ActionPartition.h"
+#include "ReachabilitySynthesizer.h"
+
+namespace Syft {
+
+/**
+ * \brief A synthesizer for the reachability game of a FOND planning domain.
+ *
+ * Computes the strong preimage action by action, using the transitions
+ * partitioned per agent action instead of the monolithic transition function.
+ * Assumes that the agent moves first and is the protagonist, and that all
+ * states in the environment-error but not in the agent-error state are goals.
+ */
+class PartitionedReachabilitySynthesizer : public ReachabilitySynthesizer {
+ private:
+
+  std::vector<ActionPartition> partitions_;
+  CUDD::BDD agent_error_var_;
+  CUDD::BDD env_error_var_;
+
+ protected:
+
+  /**
+   * \brief Computes the strong preimage of a set of states.
+   *
+   * For every agent action, the states from which all outcomes of the action
+   * lead into \a winning_states are obtained by cofactoring \a winning_states
+   * with the effects of each outcome. The results are united over actions.
+   */
+  CUDD::BDD preimage(const CUDD::BDD& winning_states) const override;
+
+ public:
+
+  /**
+   * \brief Construct a synthesizer for the given reachability game.
+   *
+   * \param spec A symbolic-state DFA representing the planning domain. Its
+   *   transition function may be empty, since preimages use \a partitions.
+   * \param goal_states The set of states that the agent must reach to win.
+   * \param state_space The set of states the game is restricted to.
+   * \param partitions The transitions of the domain, one partition per agent action.
+   * \param agent_error_var The state variable of the agent-error state.
+   * \param env_error_var The state variable of the environment-error state.
+   * \param fused If true, conjunction and quantification are fused in each
+   *   fixpoint iteration.
+   */
+  PartitionedReachabilitySynthesizer(SymbolicStateDfa spec,
+                                     CUDD::BDD goal_states,
+                                     CUDD::BDD state_space,
+                                     std::vector<ActionPartition> partitions,
+                                     CUDD::BDD agent_error_var,
+                                     CUDD::BDD env_error_var,
+                                     bool fused = false);
+};
+
+}
+
+#endif // PARTITIONED_REACHABILITY_SYNTHESIZER_H
@@ -0,0 +1,186 @@
+/*
+* declares class PddlGrounder
+* grounds FOND PDDL domain and problem files in-process,
+* replacing the translator and invariant scripts in submodules
+*/
+
+#ifndef SYFT_PDDLGROUNDER_H
+#define SYFT_PDDLGROUNDER_H
+
+#include<atomic>
+#include<map>
+#include<set>
+#include<string>
+#include<tuple>
+#include<unordered_map>
+#include<utility>
+#include<vector>
+
+namespace Syft {
+
+    /**
+     * \brief a grounded operator, as in the translator output
+    */
+    struct GroundOperator {
+        // e.g. "move-up_DETDUP_0 e1 f1 f2"
+        std::string name;
+        // (var, value) pairs
+        std::vector<std::pair<int, int>> prevail;
+        // (var, pre, post) triples, pre is -1 when unconstrained
+        std::vector<std::tuple<int, int, int>> pre_post;
+    };
+
+    /**
+     * \brief a grounded planning task, as in the translator output
+     *
+     * Each variable is binary, value 0 being the atom and value 1 its negation.
+    */
+    struct GroundTask {
+        // atom of each variable, e.g. "in(e2, f1)"
+        std::vector<std::string> atoms;
+        std::vector<int> init;
+        std::vector<std::pair<int, int>> goal;
+        std::vector<GroundOperator> operators;
+        // grounded mutex invariants, each a list of atoms
+        std::vector<std::vector<std::string>> invariants;
+    };
+
+    class PddlGrounder {
+
+        // a possibly negated atom over objects and ?-variables
+        struct Literal {
+            std::string predicate;
+            std::vector<std::string> args;
+            bool negated;
+
+            bool operator==(const Literal& rhs) const {
+                return predicate == rhs.predicate && args == rhs.args && negated == rhs.negated;
+            }
+        };
+
+        struct Atom {
+            std::string predicate;
+            std::vector<std::string> args;
+
+            bool operator<(const Atom& rhs) const {
+                return std::tie(predicate, args) < std::tie(rhs.predicate, rhs.args);
+            }
+
+            bool operator==(const Atom& rhs) const {
+                return predicate == rhs.predicate && args == rhs.args;
+            }
+        };
+
+        // one deterministic outcome of a PDDL action
+        struct Schema {
+            std::string name;
+            std::vector<std::pair<std::string, std::string>> parameters;
+            std::vector<Literal> precondition;
+            std::vector<Literal> effects;
+        };
+
+        struct SExpression {
+            std::string token;
+            std::vector<SExpression> children;
+            bool is_list;
+        };
+
+        // part of a mutex invariant candidate, as in invariants.py
+        struct InvariantPart {
+            std::string predicate;
+            std::vector<int> order;
+            int omitted_pos;
+        };
+
+        // conjunction of equalities and disjunction of inequalities
+        // between objects and ?-variables, as in constraints.py
+        using Equalities = std::vector<std::pair<std::string, std::string>>;
+
+        struct ConstraintSystem {
+            std::vector<std::vector<Equalities>> assignments;
+            std::vector<Equalities> negative_clauses;
+
+            void combine(const ConstraintSystem& other);
+
+            bool is_solvable() const;
+        };
+
+        using Invariant = std::vector<InvariantPart>;
+
+        // predicate name to types of its arguments
+        std::vector<std::pair<std::string, std::vector<std::string>>> predicates_;
+        // type name to its direct supertype
+        std::map<std::string, std::string> supertype_;
+        // objects and constants with their declared type
+        std::vector<std::pair<std::string, std::string>> objects_;
+        std::vector<Schema> schemas_;
+        std::vector<Atom> init_;
+        std::vector<Literal> goal_;
+        // grounding stops once set, may be nullptr
+        const std::atomic<bool>* cancelled_;
+
+        bool cancelled() const;
+
+        // throws std::runtime_error once grounding is cancelled
+        void check_cancelled() const;
+
+        static std::vector<SExpression> read_file(const std::string& pddl_file);
+
+        static std::vector<std::pair<std::string, std::string>> parse_typed_list(
+            const std::vector<SExpression>& list, std::size_t begin);
+
+        static Literal parse_literal(const SExpression& expression);
+
+        static void parse_condition(const SExpression& expression, std::vector<Literal>& literals);
+
+        static std::vector<std::vector<Literal>> parse_effect(const SExpression& expression);
+
+        void parse_domain(const std::string& domain_file);
+
+        void parse_problem(const std::string& problem_file);
+
+        void parse_action(const SExpression& action);
+
+        std::vector<std::vector<std::string>> get_bindings(
+            const Schema& schema,
+            const std::unordered_map<std::string, std::vector<std::vector<std::string>>>& model,
+            const std::unordered_map<std::string, std::set<std::string>>& objects_by_type) const;
+
+        std::vector<std::vector<Atom>> get_invariant_groups() const;
+
+        bool balanced(const Invariant& invariant, std::vector<Invariant>& refinements) const;
+
+        static void ensure_conjunction_sat(ConstraintSystem& system, const std::vector<Literal>& literals);
+
+        static std::vector<InvariantPart> get_matches(
+            const InvariantPart& part,
+            const Literal& own_literal,
+            const Literal& other_literal);
+
+        static std::string atom_to_string(const Atom& atom);
+
+        static GroundTask unsolvable_task();
+
+    public:
+
+        /**
+         * \brief parses PDDL domain and problem file
+         *
+         * Supports typed STRIPS with negative preconditions, equality, and
+         * oneof effects. Throws std::runtime_error on any other PDDL feature.
+         *
+         * \param cancelled if not nullptr, grounding throws
+         * std::runtime_error once it is set
+        */
+        PddlGrounder(const std::string& domain_file, const std::string& problem_file,
+            const std::atomic<bool>* cancelled = nullptr);
+
+        /**
+         * \brief grounds the task as translate.py with invariant limit 0,
+         * and its mutex invariants as invariant_finder.py and invariant_grounder.py
+        */
+        GroundTask ground() const;
+    };
+}
+
+#endif
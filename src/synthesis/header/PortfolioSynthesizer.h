@@ -0,0 +1,88 @@
+/*
+* declares class PortfolioSynthesizer
+* runs several FONDSynthesizer configurations concurrently
+*/
+
+#ifndef SYFT_PORTFOLIOSYNTHESIZER_H
+#define SYFT_PORTFOLIOSYNTHESIZER_H
+
+#include<memory>
+#include<string>
+#include<vector>
+#include"FONDSynthesizer.h"
+
+namespace Syft {
+
+    /**
+     * \brief a configuration of FONDSynthesizer run by the portfolio
+    */
+    struct PortfolioConfiguration {
+        std::string name;
+        SynthesisEngine engine;
+        bool frontier;
+        std::size_t cluster_threshold;
+        bool fused;
+        bool forward_reachability;
+        VariableOrderHeuristic var_order;
+        ReorderingPolicy reordering;
+    };
+
+    class PortfolioSynthesizer {
+
+        protected:
+            std::string domain_file_;
+            std::string problem_file_;
+            std::string cache_dir_;
+            bool prune_;
+
+            std::vector<PortfolioConfiguration> configurations_;
+
+            std::unique_ptr<FONDSynthesizer> winner_;
+            std::size_t winner_id_;
+
+        public:
+
+            /**
+             * \brief construct a portfolio of synthesizers for a FOND planning problem
+             *
+             * \param domain_file path to PDDL domain file
+             * \param problem_file path to PDDL problem file
+             * \param configurations configurations to run, one per thread
+             * \param cache_dir directory of DomainCache shared by all configurations
+             * \param prune whether all configurations prune the domain
+            */
+            PortfolioSynthesizer(
+                const std::string& domain_file,
+                const std::string& problem_file,
+                const std::vector<PortfolioConfiguration>& configurations,
+                const std::string& cache_dir = "",
+                bool prune = false
+            );
+
+            /**
+             * \brief configurations of the portfolio, one per available core
+            */
+            static std::vector<PortfolioConfiguration> default_configurations();
+
+            /**
+             * \brief runs all configurations concurrently
+             *
+             * Each configuration has its own VarMgr and CUDD manager. When a
+             * configuration terminates, the others are cancelled through the
+             * cancellation flag of their VarMgr and joined. Progress lines of
+             * the configurations are buffered, and only the winner's are printed.
+             *
+             * \return the result of the first configuration to terminate
+            */
+            SynthesisResult run();
+
+            /**
+             * \brief releases the synthesizer of the first configuration to terminate
+            */
+            std::unique_ptr<FONDSynthesizer> release_winner() {return std::move(winner_);}
+
+            std::string get_winner_name() const {return configurations_.at(winner_id_).name;}
+    };
+}
+
+#endif
@@ -1,6 +1,8 @@
 #ifndef QUANTIFICATION_H
 #define QUANTIFICATION_H
 
+#include <memory>
+
 #include <cuddObj.hh>
 
 namespace Syft {
@@ -12,6 +14,13 @@ class Quantification {
  public:
   virtual ~Quantification() {}
   virtual CUDD::BDD apply(const CUDD::BDD& bdd) const = 0;
+
+  /**
+   * \brief Quantifies the conjunction of two BDDs.
+   *
+   * Subclasses may fuse conjunction and quantification in a single pass.
+   */
+  virtual CUDD::BDD and_apply(const CUDD::BDD& f, const CUDD::BDD& g) const;
 };
 
 /**
@@ -46,6 +55,8 @@ class Exists final : public Quantification {
   Exists(CUDD::BDD existential_variables);
 
   CUDD::BDD apply(const CUDD::BDD& bdd) const override;
+
+  CUDD::BDD and_apply(const CUDD::BDD& f, const CUDD::BDD& g) const override;
 };
 
 /**
@@ -78,6 +89,8 @@ class ExistsExists final: public Quantification {
                   CUDD::BDD existential_variables_b);
 
     CUDD::BDD apply(const CUDD::BDD &bdd) const override;
+
+    CUDD::BDD and_apply(const CUDD::BDD &f, const CUDD::BDD &g) const override;
 };
 // END
 
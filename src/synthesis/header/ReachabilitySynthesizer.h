@@ -9,12 +9,17 @@ namespace Syft {
  * \brief A synthesizer for a reachability game given as a symbolic-state DFA.
  */
 class ReachabilitySynthesizer : public DfaGameSynthesizer {
- private:
+ protected:
 
   CUDD::BDD goal_states_;
   CUDD::BDD state_space_;
   CUDD::BDD winning_states_;
   CUDD::BDD winning_moves_;
+
+  bool frontier_;
+  bool fused_;
+  std::size_t iterations_;
+  std::vector<double> iteration_times_;
   
  public:
 
@@ -24,9 +29,18 @@ class ReachabilitySynthesizer : public DfaGameSynthesizer {
    * \param spec A symbolic-state DFA representing the reachability game.
    * \param starting_player The player that moves first each turn.
    * \param goal_states The set of states that the agent must reach to win.
+   * \param state_space The set of states the game is restricted to.
+   * \param frontier If true, each fixpoint iteration composes the transition
+   *   function only with the states won in the previous iteration.
+   * \param cluster_threshold If positive, the maximum size of the clusters of
+   *   the conjunctive transition relation. If 0, the transition function is used.
+   * \param fused If true, each fixpoint iteration conjoins the new winning
+   *   moves and quantifies them into states in a single pass, and the moves
+   *   are only built once, for the strategy, when the fixpoint ends.
    */
   ReachabilitySynthesizer(SymbolicStateDfa spec, Player starting_player, Player protagonist_player,
-			  CUDD::BDD goal_states, CUDD::BDD state_space);
+			  CUDD::BDD goal_states, CUDD::BDD state_space, bool frontier = false,
+			  std::size_t cluster_threshold = 0, bool fused = false);
 
     /**
      * \brief Solves the reachability game.
@@ -36,7 +50,7 @@ class ReachabilitySynthesizer : public DfaGameSynthesizer {
      * a set of agent winning states
      * a transducer representing a winning strategy or nullptr if the game is unrealizable.
      */
-  virtual SynthesisResult run() final;
+  virtual SynthesisResult run() override;
 
   /**
    * \brief gets winning states
@@ -52,6 +66,16 @@ class ReachabilitySynthesizer : public DfaGameSynthesizer {
  */
   CUDD::BDD get_winning_moves() const;
 
+  /**
+   * \brief Returns the number of fixpoint iterations of the last run.
+   */
+  std::size_t get_iterations() const;
+
+  /**
+   * \brief Returns the running time (secs) of each fixpoint iteration of the last run.
+   */
+  std::vector<double> get_iteration_times() const;
+
 };
 
 }
@@ -0,0 +1,81 @@
+#ifndef REORDERING_POLICY_H
+#define REORDERING_POLICY_H
+
+#include <memory>
+
+#include <cuddObj.hh>
+
+namespace Syft {
+
+/**
+ * \brief Dynamic variable reordering methods of CUDD.
+ */
+enum class ReorderingMethod {
+  Sift,
+  SymmetricSift,
+  GroupSift,
+  Window,
+  Annealing
+};
+
+/**
+ * \brief Dynamic variable reordering settings, per phase of synthesis.
+ *
+ * The defaults are those of CUDD, and reordering is neither forced after the
+ * construction of the domain DFA nor limited during synthesis.
+ */
+struct ReorderingPolicy {
+  ReorderingMethod method = ReorderingMethod::Sift;
+
+  // number of BDD nodes that triggers the first reordering
+  unsigned int first_threshold = 4004;
+
+  // largest growth of the BDDs allowed while moving a variable
+  double max_growth = 1.2;
+
+  // whether to reorder to convergence once the domain DFA is built
+  bool reorder_after_construction = false;
+
+  // whether action bits, reaction bits and the variables of each mutex group
+  // of the domain DFA are moved as units by reordering
+  bool variable_groups = false;
+
+  // reorderings allowed during synthesis, negative for no limit.
+  // 0 freezes the variable order
+  int synthesis_reorderings = -1;
+
+  Cudd_ReorderingType cudd_method() const;
+
+  /**
+   * \brief The variant of \a cudd_method that iterates until the BDD size
+   * stops decreasing.
+   */
+  Cudd_ReorderingType converging_cudd_method() const;
+};
+
+/**
+ * \brief Counts the reorderings of a manager and the time spent in them from
+ * its construction on.
+ */
+class ReorderingCounter {
+ private:
+
+  std::shared_ptr<CUDD::Cudd> mgr_;
+  unsigned int start_reorderings_;
+  long start_time_;
+
+ public:
+
+  explicit ReorderingCounter(std::shared_ptr<CUDD::Cudd> mgr);
+
+  unsigned int reorderings() const;
+
+  /**
+   * \brief Time spent in reorderings, in seconds.
+   */
+  double seconds() const;
+};
+
+}
+
+#endif // REORDERING_POLICY_H
@@ -0,0 +1,47 @@
+/*
+* declares class SasReader
+* reads the output.sas file of the Python translator
+*/
+
+#ifndef SYFT_SASREADER_H
+#define SYFT_SASREADER_H
+
+#include<string>
+#include<string_view>
+#include"PddlGrounder.h"
+
+namespace Syft {
+
+    class SasReader {
+
+        const char* begin_;
+        const char* end_;
+        std::size_t mapped_size_;
+
+        // next line of the mapped file, without its line break
+        std::string_view next_line(const char*& cursor) const;
+
+    public:
+
+        /**
+         * \brief memory-maps a SAS file
+         *
+         * Throws std::runtime_error if the file cannot be opened or mapped
+        */
+        SasReader(const std::string& sas_file);
+
+        SasReader(const SasReader&) = delete;
+        SasReader& operator=(const SasReader&) = delete;
+
+        ~SasReader();
+
+        /**
+         * \brief tokenizes the atoms, initial state, goal and operators in place
+         *
+         * Only atom and operator names are copied out of the mapped file
+        */
+        GroundTask read() const;
+    };
+}
+
+#endif
@@ -1,7 +1,10 @@
 #ifndef SYMBOLIC_STATE_DFA_H
 #define SYMBOLIC_STATE_DFA_H
 
+#include <istream>
+#include <map>
 #include <memory>
+#include <ostream>
 #include <vector>
 
 #include <cuddObj.hh>
@@ -29,6 +32,19 @@ class SymbolicStateDfa {
       std::shared_ptr<VarMgr>& mgr,
       std::size_t state_count);
   
+  // orders vectors of BDDs by their nodes
+  struct BddVectorLess {
+    bool operator()(const std::vector<CUDD::BDD>& lhs,
+                    const std::vector<CUDD::BDD>& rhs) const;
+  };
+
+  // ranges already computed, keyed by functions[i..]
+  using RangeCache = std::map<std::vector<CUDD::BDD>, CUDD::BDD, BddVectorLess>;
+
+  // range of functions[i..], with the value of functions[j] encoded by state variable j
+  CUDD::BDD range(const std::vector<CUDD::BDD>& functions, std::size_t i,
+                  RangeCache& cache) const;
+
   static CUDD::BDD state_to_bdd(const std::shared_ptr<VarMgr>& mgr,
 				std::size_t automaton_id,
 				std::size_t state);
@@ -116,6 +132,36 @@ class SymbolicStateDfa {
    */
   std::vector<CUDD::BDD> transition_function() const;
 
+  /**
+   * \brief Computes the set of successors of a set of states.
+   *
+   * Computes the range of the transition function constrained to \a states,
+   * splitting on the value of one state variable at a time. No next-state
+   * variables are created. Splits reaching the same constrained functions
+   * share their range, still their number may grow exponentially with the
+   * number of state variables that are not fixed by the others.
+   *
+   * \return A BDD over state variables representing all the states reachable
+   *   in one step from \a states, under any input and output.
+   */
+  CUDD::BDD image(const CUDD::BDD& states) const;
+
+  /**
+   * \brief Computes the set of states reachable from the initial state.
+   *
+   * Performs a forward fixpoint of image computations through a clustered
+   * TransitionRelation. Creates the next-state variables of the automaton if
+   * they do not exist yet, hence it must be called before vectors over all
+   * the variables of the manager are made, e.g. by a DfaGameSynthesizer.
+   *
+   * \param state_space The set of states the search is restricted to.
+   * \param cluster_threshold The maximum number of nodes of a cluster of the
+   *   transition relation. If 0, each state variable has its own cluster.
+   * \return A BDD representing the reachable states within \a state_space.
+   */
+  CUDD::BDD reachable_states(const CUDD::BDD& state_space,
+                             std::size_t cluster_threshold = 0) const;
+
   /**
    * \brief Turns the set of invalid states into a sink.
    *
@@ -136,6 +182,24 @@ class SymbolicStateDfa {
    */
   void dump_dot(const std::string& filename) const;
 
+  /**
+   * \brief Saves the DFA in a binary stream.
+   *
+   * Stores the automaton ID, the initial state, and the transition function
+   * and final states with BddSerializer. The variable manager is saved
+   * separately with VarMgr::save, since it may be shared among several DFAs.
+   */
+  void save(std::ostream& out) const;
+
+  /**
+   * \brief Loads a DFA saved by \a save.
+   *
+   * \param var_mgr A manager with the variables of the saved DFA, e.g. as
+   *   returned by VarMgr::load.
+   */
+  static SymbolicStateDfa load(std::istream& in,
+                               std::shared_ptr<VarMgr> var_mgr);
+
     /**
      * \brief Returns a product of two symbolic DFAs.
      *
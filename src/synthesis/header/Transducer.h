@@ -1,7 +1,9 @@
 #ifndef TRANSDUCER_H
 #define TRANSDUCER_H
 
+#include <istream>
 #include <memory>
+#include <ostream>
 #include <unordered_map>
 #include <vector>
 
@@ -44,11 +46,29 @@ class Transducer {
 
   std::unordered_map<int, CUDD::BDD> get_output_function() const;
 
+  std::shared_ptr<VarMgr> get_var_mgr() const { return var_mgr_; }
+
   /**
    * \brief Saves the output function of the transducer in a .dot file.
    */
   void dump_dot(const std::string& filename) const;
 
+  /**
+   * \brief Saves the transducer in a binary stream.
+   *
+   * The variable manager is saved separately with VarMgr::save.
+   */
+  void save(std::ostream& out) const;
+
+  /**
+   * \brief Loads a transducer saved by \a save.
+   *
+   * \param var_mgr A manager with the variables of the saved transducer,
+   *   e.g. as returned by VarMgr::load.
+   */
+  static std::unique_ptr<Transducer> load(std::istream& in,
+                                          std::shared_ptr<VarMgr> var_mgr);
+
 };
 
 }
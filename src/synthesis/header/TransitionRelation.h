@@ -0,0 +1,98 @@
+#ifndef TRANSITION_RELATION_H
+#define TRANSITION_RELATION_H
+
+#include <memory>
+#include <vector>
+
+#include "VarMgr.h"
+
+namespace Syft {
+
+/**
+ * \brief A clustered conjunctive transition relation T(Z, Y, X, Z').
+ *
+ * Bit relations z'_i <-> eta_i(Z, Y, X) are conjoined into clusters as long
+ * as each cluster stays within a node threshold. Preimages and images are
+ * relational products that quantify each variable as soon as no remaining
+ * cluster depends on it.
+ *
+ * The relation uses the next-state variables of the automaton in the
+ * manager, which are created the first time any relation of the automaton
+ * is built. They stay in the manager for its whole lifetime, right above
+ * the state variables, so every later reordering has to move them too.
+ */
+class TransitionRelation {
+ private:
+
+  std::shared_ptr<VarMgr> var_mgr_;
+  std::vector<CUDD::BDD> current_state_variables_;
+  std::vector<CUDD::BDD> next_state_variables_;
+
+  // clusters in the order they are conjoined, each with the cube of the
+  // variables quantified right after it
+  std::vector<CUDD::BDD> preimage_clusters_;
+  std::vector<CUDD::BDD> preimage_cubes_;
+  std::vector<CUDD::BDD> image_clusters_;
+  std::vector<CUDD::BDD> image_cubes_;
+
+  /**
+   * \brief Orders clusters with an IWLS95-style heuristic.
+   *
+   * A variable in \a quantified can be quantified as soon as no remaining
+   * cluster depends on it. At each step, picks the cluster that allows
+   * quantifying the most variables relative to its support size, breaking
+   * ties in favour of the one introducing fewer new variables.
+   *
+   * \param initial_support Variables of the set the clusters are conjoined with.
+   * \param quantified Indices of the variables to quantify.
+   */
+  void schedule(const std::vector<CUDD::BDD>& clusters,
+                const std::vector<unsigned int>& initial_support,
+                const std::vector<unsigned int>& quantified,
+                std::vector<CUDD::BDD>& ordered_clusters,
+                std::vector<CUDD::BDD>& cubes) const;
+
+ public:
+
+  /**
+   * \brief Builds the transition relation of an automaton.
+   *
+   * \param transition_function The transition function of the automaton.
+   * \param cluster_threshold The maximum number of nodes of a cluster. A bit
+   *   relation larger than the threshold forms a cluster on its own, hence 0
+   *   gives one cluster per state variable.
+   */
+  TransitionRelation(std::shared_ptr<VarMgr> var_mgr, std::size_t automaton_id,
+                     const std::vector<CUDD::BDD>& transition_function,
+                     std::size_t cluster_threshold);
+
+  /**
+   * \brief Computes exists Z'. states(Z') & T(Z, Y, X, Z').
+   *
+   * \return A BDD over state, input and output variables that holds iff the
+   *   transition leads into \a states.
+   */
+  CUDD::BDD preimage(const CUDD::BDD& states) const;
+
+  /**
+   * \brief Computes the preimage of \a states on the current states in \a care_states.
+   *
+   * \a care_states is conjoined with the first cluster, so that the later
+   * products only cover transitions from \a care_states.
+   *
+   * \return The preimage of \a states conjoined with \a care_states.
+   */
+  CUDD::BDD preimage(const CUDD::BDD& states, const CUDD::BDD& care_states) const;
+
+  /**
+   * \brief Computes the set of successors of a set of states.
+   *
+   * \return A BDD over state variables representing all the states reachable
+   *   in one step from \a states, under any input and output.
+   */
+  CUDD::BDD image(const CUDD::BDD& states) const;
+};
+
+}
+
+#endif // TRANSITION_RELATION_H
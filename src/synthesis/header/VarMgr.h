@@ -1,11 +1,15 @@
 #ifndef VAR_MGR_H
 #define VAR_MGR_H
 
+#include <atomic>
+#include <istream>
 #include <memory>
+#include <ostream>
 #include <unordered_map>
 #include <vector>
 
 #include "cuddObj.hh"
+#include "ReorderingPolicy.h"
 
 namespace Syft {
 /**
@@ -22,6 +26,9 @@ class VarMgr {
   std::vector<std::vector<CUDD::BDD>> state_variables_; // Z variables
   std::vector<CUDD::BDD> input_variables_;              // X variables
   std::vector<CUDD::BDD> output_variables_;             // Y variables
+  std::unordered_map<std::size_t, std::size_t> next_state_ids_; // Z' variables of each automaton
+  ReorderingPolicy reordering_policy_;
+  const std::atomic<bool>* cancelled_ = nullptr;
   // std::size_t total_variable_count_;    // number of Z, X and Y variables
 
   public:
@@ -94,6 +101,20 @@ class VarMgr {
 
   std::size_t create_named_state_variables(const std::vector<std::string>& vars);
 
+  /**
+   * \brief Creates next-state copies of the state variables of an automaton.
+   *
+   * Each new variable is placed right above the corresponding state variable
+   * in the variable ordering, which keeps transition relations small. The
+   * copies are created once per automaton, later calls return the same ID.
+   * They stay in the manager for its whole lifetime, doubling the number of
+   * state variables that reordering has to move.
+   *
+   * \param automaton_id The ID of the automaton whose variables to copy.
+   * \return The ID associated with the next-state variables.
+   */
+  std::size_t create_next_state_variables(std::size_t automaton_id);
+
   /**
    * \brief Registers a new automaton ID associated with a product state space.
    *
@@ -147,6 +168,42 @@ class VarMgr {
    * \brief Returns the CUDD manager used to create the variables.
    */
   std::shared_ptr<CUDD::Cudd> cudd_mgr() const;
+
+  void set_reordering_policy(const ReorderingPolicy& policy);
+
+  const ReorderingPolicy& reordering_policy() const;
+
+  /**
+   * \brief Enables dynamic reordering with the method and thresholds of the
+   * reordering policy.
+   */
+  void enable_reordering() const;
+
+  /**
+   * \brief Registers variables that dynamic reordering moves as a unit.
+   *
+   * The variables must occupy adjacent levels of the current order. Reordering
+   * may still permute them within the group.
+   *
+   * \return false, without registering a group, if \a variables are fewer
+   *   than two or not adjacent.
+   */
+  bool group_variables(const std::vector<CUDD::BDD>& variables) const;
+
+  /**
+   * \brief Sets a flag that, once true, cancels the computations over the manager.
+   *
+   * CUDD operations are aborted through a termination callback, and loops
+   * outside CUDD are expected to poll \a cancelled(). nullptr removes the flag.
+   */
+  void set_cancellation_flag(const std::atomic<bool>* cancelled);
+
+  const std::atomic<bool>* cancellation_flag() const;
+
+  /**
+   * \brief Returns whether the cancellation flag is set and true.
+   */
+  bool cancelled() const;
   
   /**
    * \brief Returns the index of the variable with the given name.
@@ -307,6 +364,23 @@ class VarMgr {
     * \return an ID to be used later.
     */
     std::size_t copy_state_variables(std::size_t automaton_id);
+
+  /**
+   * \brief Saves the variables in a binary stream.
+   *
+   * Stores the variable order, the names and indices of named variables, the
+   * input-output partition and the state variables of each automaton ID.
+   */
+  void save(std::ostream& out) const;
+
+  /**
+   * \brief Loads the variables saved by \a save into a new manager.
+   *
+   * \return A VarMgr whose variables have the same indices, order, names,
+   *   partition and automaton IDs as the saved one, so that BDDs saved over
+   *   the old manager can be loaded into the new one.
+   */
+  static std::shared_ptr<VarMgr> load(std::istream& in);
 };
 
 }
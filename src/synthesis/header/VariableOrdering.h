@@ -0,0 +1,73 @@
+/*
+* declares class VariableOrdering
+* computes static BDD variable orders from the hypergraph
+* of variables that occur together in some constraint
+*/
+
+#ifndef SYFT_VARIABLEORDERING_H
+#define SYFT_VARIABLEORDERING_H
+
+#include<cstddef>
+#include<vector>
+
+namespace Syft {
+
+    /**
+     * \brief static variable ordering heuristics
+     *
+     * Creation keeps the order in which variables are created.
+     * Interaction places next the variable that shares most
+     * constraints with the variables already placed.
+     * Force refines the Interaction order by moving each variable
+     * to the center of gravity of its constraints [Aloul, Markov,
+     * and Sakallah, GLSVLSI 2003].
+    */
+    enum class VariableOrderHeuristic {
+        Creation,
+        Interaction,
+        Force
+    };
+
+    class VariableOrdering {
+
+        std::size_t variable_count_;
+
+        // variables of each constraint, sorted and without duplicates
+        std::vector<std::vector<int>> edges_;
+
+        // constraints of each variable
+        std::vector<std::vector<int>> variable_edges_;
+
+        // FORCE stops after this many iterations if the
+        // total span of the constraints keeps decreasing
+        static constexpr std::size_t force_max_iterations_ = 50;
+
+        // sum over all constraints of the distance between
+        // their first and last variable in order
+        double span(const std::vector<int>& order) const;
+
+        std::vector<int> interaction_order() const;
+
+        std::vector<int> force_order(std::vector<int> order) const;
+
+    public:
+
+        explicit VariableOrdering(std::size_t variable_count);
+
+        /**
+         * \brief adds a constraint over some variables
+         *
+         * Constraints over fewer than two variables are ignored
+        */
+        void add_edge(std::vector<int> variables);
+
+        /**
+         * \brief computes an order of all variables
+         *
+         * \return variables from the top of the order to the bottom
+        */
+        std::vector<int> order(VariableOrderHeuristic heuristic) const;
+    };
+}
+
+#endif
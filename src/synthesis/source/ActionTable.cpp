@@ -0,0 +1,104 @@
+/*
+* Definition of class ActionTable
+*/
+
+#include"ActionTable.h"
+
+#include<algorithm>
+#include<iostream>
+#include<numeric>
+
+namespace Syft {
+
+    bool FluentRange::contains(int fluent) const {
+        return std::binary_search(begin_, end_, fluent);
+    }
+
+    void ActionTable::FluentLists::push_back(std::vector<int> fluents) {
+        std::sort(fluents.begin(), fluents.end());
+        fluents.erase(std::unique(fluents.begin(), fluents.end()), fluents.end());
+        values_.insert(values_.end(), fluents.begin(), fluents.end());
+        offsets_.push_back(values_.size());
+    }
+
+    int ActionTable::intern(const std::string& name, std::vector<std::string>& names, std::unordered_map<std::string, int>& name_to_id) {
+        auto it = name_to_id.find(name);
+        if (it != name_to_id.end()) return it->second;
+        int id = names.size();
+        names.push_back(name);
+        name_to_id.emplace(name, id);
+        return id;
+    }
+
+    bool ActionTable::add_row(
+        const std::string& name,
+        const std::string& agent_name,
+        const std::string& reaction_name,
+        std::vector<int> pos_precondition,
+        std::vector<int> neg_precondition,
+        std::vector<int> add_list,
+        std::vector<int> delete_list
+    ) {
+        if (!name_to_row_.emplace(name, names_.size()).second) return false;
+        names_.push_back(name);
+        agent_ids_.push_back(intern(agent_name, agent_names_, agent_name_to_id_));
+        reaction_ids_.push_back(intern(reaction_name, reaction_names_, reaction_name_to_id_));
+        pos_precondition_.push_back(std::move(pos_precondition));
+        neg_precondition_.push_back(std::move(neg_precondition));
+        add_list_.push_back(std::move(add_list));
+        delete_list_.push_back(std::move(delete_list));
+        return true;
+    }
+
+    void ActionTable::sort_ids(std::vector<int>& ids, std::vector<std::string>& names, std::unordered_map<std::string, int>& name_to_id) {
+        std::vector<int> order(names.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&](int lhs, int rhs) { return names[lhs] < names[rhs]; });
+
+        std::vector<int> new_id(names.size());
+        std::vector<std::string> sorted_names(names.size());
+        for (std::size_t i = 0; i < order.size(); ++i) {
+            new_id[order[i]] = i;
+            sorted_names[i] = std::move(names[order[i]]);
+        }
+        names = std::move(sorted_names);
+        for (auto& id : ids) id = new_id[id];
+        for (auto& name_id : name_to_id) name_id.second = new_id[name_id.second];
+    }
+
+    void ActionTable::sort_ids() {
+        sort_ids(agent_ids_, agent_names_, agent_name_to_id_);
+        sort_ids(reaction_ids_, reaction_names_, reaction_name_to_id_);
+    }
+
+    ActionTable ActionTable::restrict(const std::vector<bool>& agent_kept, const std::vector<int>& fluent_map) const {
+        auto rename = [&](FluentRange fluents) {
+            std::vector<int> renamed;
+            for (int i : fluents)
+                if (fluent_map[i] >= 0) renamed.push_back(fluent_map[i]);
+            return renamed;
+        };
+
+        ActionTable table;
+        for (std::size_t row = 0; row < size(); ++row) {
+            if (!agent_kept[agent_ids_[row]]) continue;
+            table.add_row(names_[row], agent_names_[agent_ids_[row]], reaction_names_[reaction_ids_[row]],
+                rename(pos_precondition(row)), rename(neg_precondition(row)), rename(add_list(row)), rename(delete_list(row)));
+        }
+        table.sort_ids();
+        return table;
+    }
+
+    void ActionTable::print(std::size_t row) const {
+        std::cout << "ACTION NAME: " << names_[row] << std::endl;
+        std::string precondition = "";
+        for (int i : pos_precondition(row)) precondition += std::to_string(i) + ", ";
+        for (int i : neg_precondition(row)) precondition += "!" + std::to_string(i) + ", ";
+        std::cout << "PRECONDITION {" + precondition.substr(0, precondition.size() - 2) + "}" << std::endl;
+        std::string add_list = "", delete_list = "";
+        for (int i : this->add_list(row)) add_list += std::to_string(i) + ", ";
+        for (int i : this->delete_list(row)) delete_list += std::to_string(i) + ", ";
+        std::cout << "ADD-LIST {" + add_list.substr(0, add_list.size() - 2) + "}" << std::endl;
+        std::cout << "DELETE-LIST {" + delete_list.substr(0, delete_list.size() - 2) + "}" << std::endl;
+    }
+}
@@ -0,0 +1,38 @@
+#include "BddReduction.h"
+
+namespace Syft {
+
+namespace {
+
+template <typename Operation>
+CUDD::BDD reduce_balanced(std::vector<CUDD::BDD>& bdds, Operation operation) {
+  while (bdds.size() > 1) {
+    std::size_t half = (bdds.size() + 1) / 2;
+    for (std::size_t i = 0; i < bdds.size() / 2; ++i)
+      bdds[i] = operation(bdds[2 * i], bdds[2 * i + 1]);
+    // an odd BDD out is carried to the next round
+    if (bdds.size() % 2 == 1) bdds[half - 1] = bdds.back();
+    bdds.resize(half);
+  }
+  return bdds.front();
+}
+
+}
+
+CUDD::BDD conjoin_balanced(const std::shared_ptr<CUDD::Cudd>& mgr,
+                           std::vector<CUDD::BDD> bdds) {
+  if (bdds.empty()) return mgr->bddOne();
+  return reduce_balanced(bdds, [](const CUDD::BDD& f, const CUDD::BDD& g) {
+    return f * g;
+  });
+}
+
+CUDD::BDD disjoin_balanced(const std::shared_ptr<CUDD::Cudd>& mgr,
+                           std::vector<CUDD::BDD> bdds) {
+  if (bdds.empty()) return mgr->bddZero();
+  return reduce_balanced(bdds, [](const CUDD::BDD& f, const CUDD::BDD& g) {
+    return f + g;
+  });
+}
+
+}
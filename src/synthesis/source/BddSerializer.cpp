@@ -0,0 +1,138 @@
+#include "BddSerializer.h"
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace Syft {
+
+namespace {
+
+const char bdd_magic[] = "SYFTBDD1";
+
+// Edges are encoded as (node << 1) | complemented, where node 0 is the
+// constant one and node k > 0 is the k-th written internal node
+std::uint64_t encode_edge(
+    DdNode* edge, const std::unordered_map<DdNode*, std::uint64_t>& node_ids) {
+  DdNode* node = Cudd_Regular(edge);
+  std::uint64_t id = Cudd_IsConstant(node) ? 0 : node_ids.at(node);
+  return (id << 1) | (Cudd_IsComplement(edge) ? 1 : 0);
+}
+
+void collect_nodes(DdNode* edge,
+                   std::unordered_map<DdNode*, std::uint64_t>& node_ids,
+                   std::vector<DdNode*>& nodes) {
+  DdNode* node = Cudd_Regular(edge);
+  if (Cudd_IsConstant(node) || node_ids.count(node) > 0) return;
+  // the depth of the recursion is bounded by the number of variables
+  collect_nodes(Cudd_T(node), node_ids, nodes);
+  collect_nodes(Cudd_E(node), node_ids, nodes);
+  nodes.push_back(node);
+  node_ids.emplace(node, nodes.size());
+}
+
+}
+
+void BddSerializer::write_uint(std::ostream& out, std::uint64_t value) {
+  out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+std::uint64_t BddSerializer::read_uint(std::istream& in) {
+  std::uint64_t value;
+  if (!in.read(reinterpret_cast<char*>(&value), sizeof(value)))
+    throw std::runtime_error("Truncated BDD stream");
+  return value;
+}
+
+void BddSerializer::write_string(std::ostream& out, const std::string& value) {
+  write_uint(out, value.size());
+  out.write(value.data(), value.size());
+}
+
+std::string BddSerializer::read_string(std::istream& in) {
+  std::string value(read_uint(in), '\0');
+  if (!in.read(&value[0], value.size()))
+    throw std::runtime_error("Truncated BDD stream");
+  return value;
+}
+
+void BddSerializer::write_magic(std::ostream& out, const char* magic) {
+  out.write(magic, 8);
+}
+
+void BddSerializer::read_magic(std::istream& in, const char* magic) {
+  char header[8];
+  if (!in.read(header, sizeof(header)) || std::memcmp(header, magic, 8) != 0)
+    throw std::runtime_error("Stream does not start with " + std::string(magic, 8));
+}
+
+void BddSerializer::write(std::ostream& out,
+                          const std::shared_ptr<CUDD::Cudd>& mgr,
+                          const std::vector<CUDD::BDD>& bdds) {
+  write_magic(out, bdd_magic);
+
+  // variable index at each level
+  int variable_count = mgr->ReadSize();
+  write_uint(out, variable_count);
+  for (int level = 0; level < variable_count; ++level)
+    write_uint(out, mgr->ReadInvPerm(level));
+
+  std::unordered_map<DdNode*, std::uint64_t> node_ids;
+  std::vector<DdNode*> nodes;
+  for (const auto& bdd : bdds) collect_nodes(bdd.getNode(), node_ids, nodes);
+
+  write_uint(out, nodes.size());
+  for (DdNode* node : nodes) {
+    write_uint(out, Cudd_NodeReadIndex(node));
+    write_uint(out, encode_edge(Cudd_T(node), node_ids));
+    write_uint(out, encode_edge(Cudd_E(node), node_ids));
+  }
+
+  write_uint(out, bdds.size());
+  for (const auto& bdd : bdds) write_uint(out, encode_edge(bdd.getNode(), node_ids));
+}
+
+std::vector<CUDD::BDD> BddSerializer::read(
+    std::istream& in, const std::shared_ptr<CUDD::Cudd>& mgr) {
+  read_magic(in, bdd_magic);
+
+  std::uint64_t variable_count = read_uint(in);
+  if (variable_count != static_cast<std::uint64_t>(mgr->ReadSize()))
+    throw std::runtime_error("BDD stream has " + std::to_string(variable_count) +
+                             " variables, manager has " +
+                             std::to_string(mgr->ReadSize()));
+
+  std::vector<int> order(variable_count);
+  for (auto& index : order) {
+    index = read_uint(in);
+    if (index < 0 || static_cast<std::uint64_t>(index) >= variable_count)
+      throw std::runtime_error("Invalid variable order in BDD stream");
+  }
+  if (variable_count > 0) mgr->ShuffleHeap(order.data());
+
+  std::vector<CUDD::BDD> nodes(1, mgr->bddOne());
+  auto decode_edge = [&](std::uint64_t edge) {
+    std::uint64_t id = edge >> 1;
+    if (id >= nodes.size()) throw std::runtime_error("Invalid node in BDD stream");
+    return (edge & 1) ? !nodes[id] : nodes[id];
+  };
+
+  std::uint64_t node_count = read_uint(in);
+  nodes.reserve(node_count + 1);
+  for (std::uint64_t i = 0; i < node_count; ++i) {
+    std::uint64_t index = read_uint(in);
+    if (index >= variable_count) throw std::runtime_error("Invalid variable in BDD stream");
+    CUDD::BDD then_child = decode_edge(read_uint(in));
+    CUDD::BDD else_child = decode_edge(read_uint(in));
+    nodes.push_back(mgr->bddVar(index).Ite(then_child, else_child));
+  }
+
+  std::uint64_t root_count = read_uint(in);
+  std::vector<CUDD::BDD> bdds;
+  bdds.reserve(root_count);
+  for (std::uint64_t i = 0; i < root_count; ++i) bdds.push_back(decode_edge(read_uint(in)));
+  return bdds;
+}
+
+}
@@ -1,23 +1,35 @@
 #include "DfaGameSynthesizer.h"
 
 #include <cassert>
+#include <unordered_map>
 
 namespace Syft {
 
 DfaGameSynthesizer::DfaGameSynthesizer(SymbolicStateDfa spec,
 				       Player starting_player,
-                       Player protagonist_player)
+                       Player protagonist_player,
+                       std::size_t cluster_threshold)
     : Synthesizer<SymbolicStateDfa>(spec)
     , starting_player_(starting_player)
     , protagonist_player_(protagonist_player){
   var_mgr_ = spec_.var_mgr();
+
+  // Next-state variables must exist before the compose and eval vectors are
+  // made, since both have to cover every variable in the manager
+  if (cluster_threshold > 0) {
+    transition_relation_ = std::make_unique<TransitionRelation>(
+      var_mgr_, spec_.automaton_id(), spec_.transition_function(), cluster_threshold);
+  }
   
   // Make versions of the initial state and transition function that can be used
-  // with CUDD::BDD::Eval and CUDD::BDD::VectorCompose, respectively
+  // with CUDD::BDD::Eval and CUDD::BDD::VectorCompose, respectively. Subclasses
+  // with their own preimage may get a DFA without a transition function
   initial_vector_ = var_mgr_->make_eval_vector(spec_.automaton_id(),
 					       spec_.initial_state());  
-  transition_vector_ = var_mgr_->make_compose_vector(
-      spec_.automaton_id(), spec_.transition_function());
+  if (!spec_.transition_function().empty()) {
+    transition_vector_ = var_mgr_->make_compose_vector(
+        spec_.automaton_id(), spec_.transition_function());
+  }
   
   CUDD::BDD input_cube = var_mgr_->input_cube();
   CUDD::BDD output_cube = var_mgr_->output_cube();
@@ -53,13 +65,43 @@ CUDD::BDD DfaGameSynthesizer::preimage(
     const CUDD::BDD& winning_states) const {
   // Transitions that move into a winning state
   // std::cout << "collecting winning transitions..." << std::flush;
-  CUDD::BDD winning_transitions =
-    winning_states.VectorCompose(transition_vector_);
+  CUDD::BDD winning_transitions = compose(winning_states);
   // std::cout << std::endl;
   // Quantify all variables that the outputs don't depend on
   return quantify_independent_variables_->apply(winning_transitions);
 }
 
+CUDD::BDD DfaGameSynthesizer::preimage(const CUDD::BDD& winning_states,
+                                       const CUDD::BDD& care_states) const {
+  CUDD::BDD winning_transitions;
+  if (transition_relation_) {
+    winning_transitions = transition_relation_->preimage(winning_states, care_states);
+  } else {
+    // Composing with the constrained functions agrees with composing with the
+    // original ones on care_states (Coudert and Madre)
+    std::vector<CUDD::BDD> constrained_function;
+    for (const auto& bit_function : spec_.transition_function())
+      constrained_function.push_back(bit_function.Constrain(care_states));
+    winning_transitions = care_states * winning_states.VectorCompose(
+      var_mgr_->make_compose_vector(spec_.automaton_id(), constrained_function));
+  }
+  return quantify_independent_variables_->apply(winning_transitions);
+}
+
+CUDD::BDD DfaGameSynthesizer::compose(const CUDD::BDD& states) const {
+  if (transition_relation_) {
+    return transition_relation_->preimage(states);
+  }
+  return states.VectorCompose(transition_vector_);
+}
+
+CUDD::BDD DfaGameSynthesizer::image(const CUDD::BDD& states) const {
+  if (transition_relation_) {
+    return transition_relation_->image(states);
+  }
+  return spec_.image(states);
+}
+
 CUDD::BDD DfaGameSynthesizer::project_into_states(
     const CUDD::BDD& winning_moves) const {
   return quantify_non_state_variables_->apply(winning_moves);
@@ -4,52 +4,190 @@
 
 #include"Domain.h"
 
+#include<algorithm>
+#include"BddReduction.h"
+#include"BddSerializer.h"
+#include"Stopwatch.h"
+#include<filesystem>
+#include<future>
+#include<numeric>
+#include<stdlib.h>
+
 namespace Syft {
 
     Domain::Domain(
         std::shared_ptr<Syft::VarMgr> var_mgr,
         const std::string& domain_pddl,
-        const std::string& problem_pddl
-    ): var_mgr_(var_mgr) {
-        // parse domain and problem PDDL to generate output.sas file
-        std::string translate_command = "./../../submodules/translate.py 0 " + domain_pddl + " " + problem_pddl;
-        system(translate_command.c_str());
-
-        // read output.sas to generate data members
-        parse_sas(); 
-
-        // generate invariants in three files
-        // 1. predicate file
-        // 2. objects file
-        // 3. invariants file
-        std::string invariants_command = "./../../submodules/invariant_finder.py " + domain_pddl + " " + problem_pddl;
-        system(invariants_command.c_str());
+        const std::string& problem_pddl,
+        bool python_grounding,
+        const std::string& cache_dir,
+        bool prune,
+        bool log_encoding,
+        VariableOrderHeuristic var_order,
+        const std::string& order_file
+    ): var_mgr_(var_mgr), log_encoding_(log_encoding), var_order_(var_order) {
+        if (!order_file.empty()) learned_order_ = LearnedOrder::load(order_file);
+        if (!cache_dir.empty()) {
+            std::string options = python_grounding ? "python-grounding" : "";
+            if (prune) options += ";prune";
+            if (log_encoding) options += ";log-encoding";
+            if (var_mgr->reordering_policy().variable_groups) options += ";var-groups";
+            if (!learned_order_.empty()) options += ";order=" + boost::algorithm::join(learned_order_.names(), ",");
+            if (var_order != VariableOrderHeuristic::Creation) options += ";var-order=" + std::to_string(static_cast<int>(var_order));
+            cache_ = std::make_shared<DomainCache>(cache_dir, domain_pddl, problem_pddl, options);
+        }
 
-        // debug
-        // for (const auto& p : var_to_id) std::cout << "Var: " << p.first << ". ID: " << p.second << std::endl; 
+        GroundTask task;
+        if (!cache_ || !cache_->load_task(task)) {
+            if (!python_grounding) {
+                try {
+                    task = PddlGrounder(domain_pddl, problem_pddl, var_mgr_->cancellation_flag()).ground();
+                } catch (const std::runtime_error& e) {
+                    if (var_mgr_->cancelled()) throw;
+                    // PDDL features beyond the grounder are left to the translator
+                    std::cerr << "[pddl2dfa] " << e.what() << ". Grounding with Python translator" << std::endl;
+                    python_grounding = true;
+                }
+            }
+            if (python_grounding) task = ground_with_python(domain_pddl, problem_pddl);
+            if (cache_) cache_->store_task(task);
+        }
+
+        load_task(task);
+        compile_rigid_atoms();
+        if (prune) prune_task();
+    }
 
-        // generate grounded_invs file
-        std::string ground_invariants_command = "./../../submodules/invariant_grounder.py";
-        system(ground_invariants_command.c_str());
+    GroundTask Domain::ground_with_python(const std::string& domain_pddl, const std::string& problem_pddl) const {
+        // the translator and invariant scripts write their output files in
+        // the working directory. Running them in a scratch directory of
+        // their own lets several processes ground in the same directory
+        std::filesystem::path submodules = std::filesystem::absolute("../../submodules");
+        std::string domain_path = std::filesystem::absolute(domain_pddl).string();
+        std::string problem_path = std::filesystem::absolute(problem_pddl).string();
+
+        std::string scratch_template = (std::filesystem::temp_directory_path() / "syft4fond-XXXXXX").string();
+        if (mkdtemp(scratch_template.data()) == nullptr) throw std::runtime_error("Unable to create scratch directory for PDDL grounding");
+        std::filesystem::path scratch(scratch_template);
+        std::string enter_scratch = "cd '" + scratch.string() + "' && ";
+
+        GroundTask task;
+        try {
+            // generate invariants in three files
+            // 1. predicate file
+            // 2. objects file
+            // 3. invariants file
+            // and ground them in grounded_invs file. The invariant scripts
+            // do not depend on the translator, hence they run concurrently
+            std::string invariants_command = enter_scratch + "'" + (submodules / "invariant_finder.py").string() + "' '" + domain_path + "' '" + problem_path + "' && '" + (submodules / "invariant_grounder.py").string() + "'";
+            std::future<int> invariants_done = std::async(std::launch::async, [invariants_command]() {
+                return system(invariants_command.c_str());
+            });
+
+            // parse domain and problem PDDL to generate output.sas file
+            std::string translate_command = enter_scratch + "'" + (submodules / "translate.py").string() + "' 0 '" + domain_path + "' '" + problem_path + "'";
+            system(translate_command.c_str());
+
+            // read output.sas while invariants are still being found
+            task = SasReader((scratch / "output.sas").string()).read();
+
+            invariants_done.get();
+            std::ifstream inv_input_stream(scratch / "grounded_invs.txt");
+            std::string inv_line;
+            while (std::getline(inv_input_stream, inv_line)) {
+                std::vector<std::string> inv_vec;
+                boost::split(inv_vec, inv_line, boost::is_any_of(";"));
+                task.invariants.push_back(inv_vec);
+            }
+        } catch (...) {
+            std::filesystem::remove_all(scratch);
+            throw;
+        }
+        std::filesystem::remove_all(scratch);
+        return task;
+    }
+
+    void Domain::load_task(const GroundTask& task) {
+        for (std::string var : task.atoms) {
+            boost::replace_all(var, "(", "_");
+            boost::replace_all(var, ")", "_");
+            boost::replace_all(var, " ", "");
+            boost::replace_all(var, ",", "_");
+            boost::replace_all(var, "-", "_");
+            boost::trim_if(var, boost::is_any_of("_"));
+            boost::to_lower(var);
+            vars_.push_back(var);
+        }
+
+        // in .sas 0 is "true" and 1 is "false"
+        // to match LydiaSyft: 0->1 and 1->0 in init state
+        for (int value : task.init) {
+            if (value == 0) init_state_.push_back(1);
+            else if (value == 1) init_state_.push_back(0);
+        }
+
+        for (const auto& op : task.operators) {
+            // action name
+            // preprocessing for compatibility with LydiaSyft's syntax
+            std::string action_name = op.name;
+            boost::replace_all(action_name, "-", "_");
+            boost::replace_all(action_name, " ", "_");
+            boost::to_lower(action_name);
+            boost::replace_all(action_name, "detdup", "REACT");
+            auto i = action_name.find("REACT_");
+            if (i == std::string::npos) action_name = action_name + "_REACT_0";
+            else {
+                auto j = action_name.find("_", i+1);
+                auto k = action_name.find("_", j+1);
+                std::string react_id = action_name.substr(i, k-i);
+                boost::replace_all(action_name, "_" + react_id, "");
+                action_name = action_name + "_" + react_id;
+            }
+
+            // splits action and reaction name once, rows refer to them by id
+            std::size_t split_index = action_name.find("_REACT");
+            std::string agent_name = action_name.substr(0, split_index);
+            std::string reaction_name = action_name.substr(split_index);
+
+            std::vector<int> pos_preconditions, neg_preconditions, add_list, delete_list;
+            for (const auto& precondition : op.prevail) {
+                if (precondition.second == 0) pos_preconditions.push_back(precondition.first);
+                else if (precondition.second == 1) neg_preconditions.push_back(precondition.first);
+            }
+            for (const auto& effect : op.pre_post) {
+                int var = std::get<0>(effect), pre = std::get<1>(effect), post = std::get<2>(effect);
+                if (pre == -1 && post == 0) add_list.push_back(var);
+                else if (pre == 1 && post == 0) add_list.push_back(var);
+                else if (pre == 0 && post == 1) delete_list.push_back(var);
+            }
+            actions_.add_row(action_name, agent_name, reaction_name,
+                std::move(pos_preconditions), std::move(neg_preconditions), std::move(add_list), std::move(delete_list));
+        }
+        actions_.sort_ids();
+
+        for (const auto& goal : task.goal) {
+            if (goal.second == 0) pos_goal_list_.insert(goal.first);
+            else neg_goal_list_.insert(-goal.first);
+        }
+        // print_domain();
 
         // grounds invariants
         // auxiliary data structure
         std::unordered_map<std::string, int> var_to_id;
         for (int i = 0; i < vars_.size(); ++i) var_to_id.insert(std::make_pair(vars_[i], i));
 
-        std::ifstream inv_input_stream("grounded_invs.txt");
-        std::string inv_line;
-        while (std::getline(inv_input_stream, inv_line)) {
-            boost::replace_all(inv_line, "(", "_");
-            boost::replace_all(inv_line, ")", "_");
-            boost::replace_all(inv_line, " ", "");
-            boost::replace_all(inv_line, ",", "_");
-            boost::replace_all(inv_line, "-", "_");
-            boost::to_lower(inv_line);
-            // std::cout << inv_line << std::endl;
+        for (const auto& invariant : task.invariants) {
             std::vector<std::string> inv_vec;
-            boost::split(inv_vec, inv_line, boost::is_any_of(";"));
-            for (auto& atom : inv_vec) boost::trim_if(atom, boost::is_any_of("_"));
+            for (std::string atom : invariant) {
+                boost::replace_all(atom, "(", "_");
+                boost::replace_all(atom, ")", "_");
+                boost::replace_all(atom, " ", "");
+                boost::replace_all(atom, ",", "_");
+                boost::replace_all(atom, "-", "_");
+                boost::to_lower(atom);
+                boost::trim_if(atom, boost::is_any_of("_"));
+                inv_vec.push_back(atom);
+            }
 
             // debug
             // std::cout << "Invariant: " << std::flush;
@@ -62,96 +200,173 @@ namespace Syft {
         }
     }
 
-    void Domain::parse_sas() {
-            std::ifstream sas_input_stream("output.sas");
-            std::string line;
-            while (std::getline(sas_input_stream, line)) {
-                // std::cout << line << std::endl;
-                if (boost::starts_with(line, "Atom")) {
-                    std::string var = line.substr(5);
-                    boost::replace_all(var, "(", "_");
-                    boost::replace_all(var, ")", "_");
-                    boost::replace_all(var, " ", "");
-                    boost::replace_all(var, ",", "_");
-                    boost::replace_all(var, "-", "_");
-                    boost::trim_if(var, boost::is_any_of("_"));
-                    boost::to_lower(var);
-                    vars_.push_back(var);
-                } else if (boost::starts_with(line, "begin_state")) { // reads initial state information
-                    while (line != "end_state") {
-                        std::getline(sas_input_stream, line);
-                        // in .sas 0 is "true" and 1 is "false"
-                        // to match LydiaSyft: 0->1 and 1->0 in init state
-                        if (line == "0") init_state_.push_back(1);
-                        else if (line == "1") init_state_.push_back(0); 
-                    }
-                } else if (boost::starts_with(line, "begin_operator")) { // reads action information
-                    std::string action_name;
-                    std::unordered_set<int> pos_preconditions, neg_preconditions, add_list, delete_list;
-                    while (line != "end_operator") {
-                        std::getline(sas_input_stream, line);
-                        if (!((boost::starts_with(line, "  ")) || line == "end_operator")) {
-                            // action name
-                            // preprocessing for compatibility with LydiaSyft's syntax
-                            action_name = line;
-                            boost::replace_all(action_name, "-", "_");
-                            boost::replace_all(action_name, " ", "_");
-                            boost::to_lower(action_name);
-                            boost::replace_all(action_name, "detdup", "REACT");
-                            auto i = action_name.find("REACT_");
-                            if (i == std::string::npos) action_name = action_name + "_REACT_0";
-                            else {
-                                auto j = action_name.find("_", i+1);
-                                auto k = action_name.find("_", j+1);
-                                std::string react_id = action_name.substr(i, k-i);
-                                boost::replace_all(action_name, "_" + react_id, "");
-                                action_name = action_name + "_" + react_id;
-                            }
-                            // std::cout << "Current action name: " << action_name << std::endl;
-                        } else if (boost::starts_with(line, "  ")) {
-                            boost::trim(line);
-                            // std::cout << line << std::endl;
-                            std::vector<std::string> substr_vec;
-                            boost::split(substr_vec, line, boost::is_any_of(" "));
-                            int var = std::stoi(substr_vec[0].substr(1, substr_vec[0].size() - 2));
-                            if (substr_vec.size() == 2) {
-                                // we are handling a precondition
-                                if (substr_vec[1] == "0") pos_preconditions.insert(+var);
-                                else if (substr_vec[1] == "1") neg_preconditions.insert(-var);
-                            } else if (substr_vec.size() == 4) {
-                                // we are handling an effect
-                                if (substr_vec[1] == "-1" && substr_vec[3] == "0") add_list.insert(var);
-                                else if (substr_vec[1] == "1" && substr_vec[3] == "0") add_list.insert(var);
-                                else if (substr_vec [1] == "0" && substr_vec[3] == "1") delete_list.insert(var);
-                            }
-                        }
-                    }
-                    Action new_action(action_name, pos_preconditions, neg_preconditions, add_list, delete_list);
-                    // new_action.print();
-                    actions_.insert(new_action);
-                } else if (boost::starts_with(line, "begin_goal")) { // reads goal information
-                    while (line != "end_goal") {
-                        std::getline(sas_input_stream, line);
-                        std::vector<std::string> substr_vec;
-                        boost::split(substr_vec, line, boost::is_any_of(" "));
-                        if (substr_vec.size() == 2) {
-                            int var = std::stoi(substr_vec[0]);
-                            if (substr_vec[1] == "0") pos_goal_list_.insert(var);
-                            else neg_goal_list_.insert(-var);
-                        }
-                    }
+    void Domain::prune_task() {
+        std::size_t var_count = vars_.size();
+
+        // relaxed reachability. Collects the literals that may hold in some
+        // reachable state, ignoring that actions make other literals false.
+        // Preconditions are shared by all reactions to an agent action
+        std::vector<bool> may_be_true(var_count), may_be_false(var_count);
+        for (std::size_t i = 0; i < var_count; ++i) {
+            may_be_true[i] = init_state_[i] == 1;
+            may_be_false[i] = init_state_[i] == 0;
+        }
+        std::vector<bool> reachable(actions_.agent_count(), false);
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            for (std::size_t row = 0; row < actions_.size(); ++row) {
+                int agent_id = actions_.agent_id(row);
+                if (!reachable[agent_id]) {
+                    bool applicable = true;
+                    for (int i : actions_.pos_precondition(row)) applicable = applicable && may_be_true[i];
+                    for (int i : actions_.neg_precondition(row)) applicable = applicable && may_be_false[i];
+                    if (!applicable) continue;
+                    reachable[agent_id] = true;
                 }
+                for (int i : actions_.add_list(row))
+                    if (!may_be_true[i]) may_be_true[i] = changed = true;
+                for (int i : actions_.delete_list(row))
+                    if (!may_be_false[i]) may_be_false[i] = changed = true;
             }
-            // print_domain(); 
         }
 
-    SymbolicStateDfa Domain::to_ltlf_and_symbolic() {
-        var_mgr_->cudd_mgr() -> AutodynEnable();
+        // goal relevance. Collects the atoms the goal depends on, directly or
+        // through the precondition of an action affecting a relevant atom
+        std::vector<bool> relevant_var(var_count, false);
+        for (int i : pos_goal_list_) relevant_var[i] = true;
+        for (int i : neg_goal_list_) relevant_var[-i] = true;
+        std::vector<bool> relevant(actions_.agent_count(), false);
+        changed = true;
+        while (changed) {
+            changed = false;
+            for (std::size_t row = 0; row < actions_.size(); ++row) {
+                int agent_id = actions_.agent_id(row);
+                if (!reachable[agent_id] || relevant[agent_id]) continue;
+                for (int i : actions_.add_list(row)) relevant[agent_id] = relevant[agent_id] || relevant_var[i];
+                for (int i : actions_.delete_list(row)) relevant[agent_id] = relevant[agent_id] || relevant_var[i];
+                changed = changed || relevant[agent_id];
+            }
+            for (std::size_t row = 0; row < actions_.size(); ++row) {
+                if (!relevant[actions_.agent_id(row)]) continue;
+                for (int i : actions_.pos_precondition(row))
+                    if (!relevant_var[i]) relevant_var[i] = changed = true;
+                for (int i : actions_.neg_precondition(row))
+                    if (!relevant_var[i]) relevant_var[i] = changed = true;
+            }
+        }
+
+        // with no relevant action the goal holds initially or never,
+        // the domain is left as is to keep an action to encode
+        pruning_.vars = var_count;
+        pruning_.actions = actions_.size();
+        if (std::find(relevant.begin(), relevant.end(), true) == relevant.end()) return;
+
+        // keeps relevant atoms that are not constant in relaxed reachability.
+        // Constant atoms in kept actions are satisfied preconditions or void
+        // effects. Goal atoms are always kept, they may be unreachable
+        std::vector<int> fluent_map(var_count, -1);
+        int kept_vars = 0;
+        for (std::size_t i = 0; i < var_count; ++i) {
+            bool goal = pos_goal_list_.count(i) > 0 || neg_goal_list_.count(-static_cast<int>(i)) > 0;
+            if (!goal && !(may_be_true[i] && may_be_false[i])) ++pruning_.constant_vars;
+            else if (!relevant_var[i]) ++pruning_.irrelevant_vars;
+            else fluent_map[i] = kept_vars++;
+        }
+
+        for (std::size_t row = 0; row < actions_.size(); ++row) {
+            if (!reachable[actions_.agent_id(row)]) ++pruning_.unreachable_actions;
+            else if (!relevant[actions_.agent_id(row)]) ++pruning_.irrelevant_actions;
+        }
 
-        std::pair<std::unordered_set<std::string>, std::unordered_set<std::string>> action_reaction_names 
-            = get_action_reaction_names();
+        restrict_task(relevant, fluent_map);
+    }
+
+    void Domain::compile_rigid_atoms() {
+        std::size_t var_count = vars_.size();
+
+        // atoms in no add- or delete-list keep their initial value
+        std::vector<bool> rigid(var_count, true);
+        for (std::size_t row = 0; row < actions_.size(); ++row) {
+            for (int i : actions_.add_list(row)) rigid[i] = false;
+            for (int i : actions_.delete_list(row)) rigid[i] = false;
+        }
+
+        // a goal violated by a rigid atom is never reached,
+        // such atoms are kept so that the goal stays false
+        for (int i : pos_goal_list_) if (init_state_[i] != 1) rigid[i] = false;
+        for (int i : neg_goal_list_) if (init_state_[-i] != 0) rigid[-i] = false;
+
+        // agent actions with a precondition violated by a rigid atom are never applicable
+        std::vector<bool> applicable(actions_.agent_count(), true);
+        for (std::size_t row = 0; row < actions_.size(); ++row) {
+            int agent_id = actions_.agent_id(row);
+            for (int i : actions_.pos_precondition(row))
+                if (rigid[i] && init_state_[i] != 1) applicable[agent_id] = false;
+            for (int i : actions_.neg_precondition(row))
+                if (rigid[i] && init_state_[i] != 0) applicable[agent_id] = false;
+        }
+        // the domain is left as is to keep an action to encode
+        if (std::find(applicable.begin(), applicable.end(), true) == applicable.end()) return;
+
+        std::vector<int> fluent_map(var_count, -1);
+        int kept_vars = 0;
+        for (std::size_t i = 0; i < var_count; ++i) {
+            if (rigid[i]) ++pruning_.rigid_vars;
+            else fluent_map[i] = kept_vars++;
+        }
+        for (std::size_t row = 0; row < actions_.size(); ++row)
+            if (!applicable[actions_.agent_id(row)]) ++pruning_.inapplicable_actions;
+
+        if (pruning_.rigid_vars > 0) restrict_task(applicable, fluent_map);
+    }
+
+    void Domain::restrict_task(const std::vector<bool>& agent_kept, const std::vector<int>& fluent_map) {
+        std::vector<std::string> vars;
+        std::vector<int> init_state;
+        for (std::size_t i = 0; i < vars_.size(); ++i) {
+            if (fluent_map[i] < 0) continue;
+            vars.push_back(vars_[i]);
+            init_state.push_back(init_state_[i]);
+        }
+        vars_ = vars;
+        init_state_ = init_state;
+
+        actions_ = actions_.restrict(agent_kept, fluent_map);
+
+        // goal atoms left out are satisfied constants
+        std::unordered_set<int> pos_goal_list, neg_goal_list;
+        for (int i : pos_goal_list_) if (fluent_map[i] >= 0) pos_goal_list.insert(fluent_map[i]);
+        for (int i : neg_goal_list_) if (fluent_map[-i] >= 0) neg_goal_list.insert(-fluent_map[-i]);
+        pos_goal_list_ = pos_goal_list;
+        neg_goal_list_ = neg_goal_list;
+
+        // invariants only restrict the state space, dropping atoms weakens them
+        std::unordered_set<Invariant, InvariantHash> invariants;
+        for (const auto& inv : invariants_) {
+            std::unordered_set<int> pos_vars, neg_vars;
+            for (int i : inv.get_pos_vars()) if (fluent_map[i] >= 0) pos_vars.insert(fluent_map[i]);
+            for (int i : inv.get_neg_vars()) if (fluent_map[i] >= 0) neg_vars.insert(fluent_map[i]);
+            if (pos_vars.size() + neg_vars.size() > 1) invariants.insert(Invariant(pos_vars, neg_vars));
+        }
+        invariants_ = invariants;
+    }
+
+    void Domain::print_pruning(std::ostream& out) const {
+        if (pruning_.rigid_vars > 0)
+            out << "[pddl2dfa] Compiled out " << pruning_.rigid_vars << " rigid atoms and "
+                << pruning_.inapplicable_actions << " action-reaction pairs with violated preconditions" << std::endl;
+        if (pruning_.vars == 0) return;
+        out << "[pddl2dfa] Pruned " << pruning_.constant_vars + pruning_.irrelevant_vars << " of " << pruning_.vars << " atoms ("
+            << pruning_.constant_vars << " constant, " << pruning_.irrelevant_vars << " irrelevant) and "
+            << pruning_.unreachable_actions + pruning_.irrelevant_actions << " of " << pruning_.actions << " action-reaction pairs ("
+            << pruning_.unreachable_actions << " unreachable, " << pruning_.irrelevant_actions << " irrelevant)" << std::endl;
+    }
+
+    SymbolicStateDfa Domain::to_ltlf_and_symbolic() {
+        var_mgr_->enable_reordering();
 
-        std::pair<std::string, std::string> agent_env_mutex_axioms = get_ltlf_action_reaction_vars(action_reaction_names.first, action_reaction_names.second);
+        std::pair<std::string, std::string> agent_env_mutex_axioms = get_ltlf_action_reaction_vars();
 
         // debug
         // print_domain();
@@ -192,10 +407,10 @@ namespace Syft {
         return domain_dfa;
     }
 
-    std::pair<std::string, std::string> Domain::get_ltlf_action_reaction_vars(const std::unordered_set<std::string>& action_names, const std::unordered_set<std::string>& reaction_names) {
+    std::pair<std::string, std::string> Domain::get_ltlf_action_reaction_vars() {
         // create and partition input and output vars
-        std::size_t action_bits = get_bits(action_names);
-        std::size_t reaction_bits = get_bits(reaction_names);
+        std::size_t action_bits = get_bits(actions_.agent_count());
+        std::size_t reaction_bits = get_bits(actions_.reaction_count());
 
         for (int i = 0; i < action_bits; ++i) action_vars_.push_back("a_" + std::to_string(i));
         for (int i = 0; i < reaction_bits; ++i) reaction_vars_.push_back("r_" + std::to_string(i));
@@ -213,14 +428,12 @@ namespace Syft {
         var_mgr_->create_input_variables(domain_vars);
 
         // define encoding for action and reaction vars
-        std::unordered_map<std::string, std::string> action_name_to_ltlf;
-        std::unordered_map<std::string, std::string> reaction_name_to_ltlf;
-    
         std::string agent_ltlf_mutex = "";
         std::string env_ltlf_mutex = "";
 
-        int act_int_id = 0, react_int_id = 0;
-        for (const auto& action_name : action_names) {
+        agent_ltlfs_.clear();
+        reaction_ltlfs_.clear();
+        for (int act_int_id = 0; act_int_id < actions_.agent_count(); ++act_int_id) {
             std::vector<int> act_bin_id = to_bits(act_int_id, action_bits);
             std::string act_ltlf = "";
             for (int i = 0; i < act_bin_id.size(); ++i) {
@@ -228,15 +441,14 @@ namespace Syft {
                 else if (act_bin_id[i] == 0) act_ltlf += "!a_" + std::to_string(i) + " && ";
             }
             act_ltlf = "(" + act_ltlf.substr(0, act_ltlf.size()-4) + ")";
-            action_name_to_ltlf.insert(std::make_pair(action_name, act_ltlf));
+            agent_ltlfs_.push_back(act_ltlf);
             agent_ltlf_mutex += act_ltlf + " || "; 
-            id_to_action_name_.insert(std::make_pair(act_int_id, action_name));
-            ++act_int_id; 
+            id_to_action_name_.insert(std::make_pair(act_int_id, actions_.agent_name(act_int_id)));
         }
         agent_ltlf_mutex = agent_ltlf_mutex.substr(0, agent_ltlf_mutex.size() - 4);
         agent_ltlf_mutex = "(" + agent_ltlf_mutex + ")";
         
-        for (const auto& reaction_name : reaction_names) {
+        for (int react_int_id = 0; react_int_id < actions_.reaction_count(); ++react_int_id) {
             std::vector<int> react_bin_id = to_bits(react_int_id, reaction_bits);
             std::string react_ltlf = "";
             for (int i = 0; i < react_bin_id.size(); ++i) {
@@ -244,39 +456,14 @@ namespace Syft {
                 else if (react_bin_id[i] == 0) react_ltlf += "!r_"+std::to_string(i) + " && ";
             }
             react_ltlf = "(" + react_ltlf.substr(0, react_ltlf.size() -4) + ")";
-            reaction_name_to_ltlf.insert(std::make_pair(reaction_name, react_ltlf));
+            reaction_ltlfs_.push_back(react_ltlf);
             env_ltlf_mutex += react_ltlf + " || ";
-            id_to_reaction_name_.insert(std::make_pair(react_int_id, reaction_name));
-            ++react_int_id;
+            id_to_reaction_name_.insert(std::make_pair(react_int_id, actions_.reaction_name(react_int_id)));
         }
         env_ltlf_mutex = env_ltlf_mutex.substr(0, env_ltlf_mutex.size() - 4);
         env_ltlf_mutex = "(" + env_ltlf_mutex + ")";
 
 
-        std::unordered_set<Action, ActionHash> updated_actions;
-        for (Action act : actions_) {
-            // std::cout << "Encoding action: " << act.get_action_name() << std::endl;
-
-            std::string action_reaction_name = act.get_action_name();
-
-            // finds where action and reaction name splits
-            int split_index = action_reaction_name.find("_REACT");
-
-            std::string reaction_name = action_reaction_name.substr(split_index);
-            std::string action_name = boost::replace_all_copy(action_reaction_name, reaction_name, "");
-
-            act.set_agent_ltlf(action_name_to_ltlf[action_name]);
-            act.set_env_ltlf(reaction_name_to_ltlf[reaction_name]);
-            act.set_action_ltlf("(" + action_name_to_ltlf[action_name] + " && " + reaction_name_to_ltlf[reaction_name] + ")");
-
-            // act.set_action_bin(action_name_to_bin[action_name]);
-            // act.set_env_bin(reaction_name_to_bin[reaction_name]);
-
-            updated_actions.insert(act);
-        }
-
-        actions_ = updated_actions;
-
         return std::make_pair(std::string(agent_ltlf_mutex), std::string(env_ltlf_mutex));
     }
 
@@ -307,19 +494,10 @@ namespace Syft {
         std::vector<std::string> add_ltlf(vars_.size(), "");
         std::vector<std::string> del_ltlf(vars_.size(), "");
 
-        for (const auto& act : actions_) {
-            auto act_add_list = act.get_add_list();
-            auto act_del_list = act.get_del_list(); 
-            for (const auto& id : act_add_list) {
-                // debug
-                // std::cout << "Action: " << act.get_action_name() << ". Added to var " << vars_[id] << " LTLf add list" << std::endl;
-                add_ltlf[id] = add_ltlf[id] + "(" + act.get_action_ltlf() + ") || ";
-            }
-            for (const auto& id : act_del_list) {
-                // debug
-                // std::cout << "Action: " << act.get_action_name() << ". Added to var " << vars_[id] << " LTLf del list" << std::endl;
-                del_ltlf[id] = del_ltlf[id] + "(" + act.get_action_ltlf() + ") || ";
-            }
+        for (std::size_t row = 0; row < actions_.size(); ++row) {
+            std::string act_ltlf = "((" + agent_ltlfs_[actions_.agent_id(row)] + " && " + reaction_ltlfs_[actions_.reaction_id(row)] + ")) || ";
+            for (int id : actions_.add_list(row)) add_ltlf[id] += act_ltlf;
+            for (int id : actions_.delete_list(row)) del_ltlf[id] += act_ltlf;
         }
         for (int i = 0; i < add_ltlf.size(); ++i) {
             if (add_ltlf[i] == "") add_ltlf[i] = "(false)";
@@ -356,29 +534,22 @@ namespace Syft {
 
     std::string Domain::get_ltlf_agent_pre() const {
         std::string agent_pre_ltlf = "";
-        std::unordered_set<std::string> added_action_names;
+        std::vector<bool> added_actions(actions_.agent_count(), false);
         // debug
         // std::cout << "Number of agent-reaction: " << actions_.size() << std::endl;
-        for (const auto& act: actions_) {
-            std::string action_reaction_name = act.get_action_name();
+        for (std::size_t row = 0; row < actions_.size(); ++row) {
+            int agent_id = actions_.agent_id(row);
 
-            int split_index = action_reaction_name.find("_REACT");
+            if (!added_actions[agent_id]) { // action has not been added to agent pre
+                added_actions[agent_id] = true;
 
-            std::string reaction_name = action_reaction_name.substr(split_index);
-            std::string action_name = boost::replace_all_copy(action_reaction_name, reaction_name, "");
-
-            if (added_action_names.find(action_name) == added_action_names.end()) { // action name has not been added to agent pre
-                added_action_names.insert(action_name);
-
-                auto act_pos_pre = act.get_pos_pre();
-                auto act_neg_pre = act.get_neg_pre();
                 std::string act_pre_ltlf = "";
-                for (const auto& i : act_pos_pre) act_pre_ltlf += vars_[i] + " && ";
-                for (const auto& i : act_neg_pre) act_pre_ltlf += "!" + vars_[-i] + " && ";
+                for (int i : actions_.pos_precondition(row)) act_pre_ltlf += vars_[i] + " && ";
+                for (int i : actions_.neg_precondition(row)) act_pre_ltlf += "!" + vars_[i] + " && ";
                 if (act_pre_ltlf == "") act_pre_ltlf = "(true)";
                 else act_pre_ltlf = "(" + act_pre_ltlf.substr(0, act_pre_ltlf.size()-4) + ")";
 
-                act_pre_ltlf = "(" + act.get_agent_ltlf() + " -> " + act_pre_ltlf + ")";
+                act_pre_ltlf = "(" + agent_ltlfs_[agent_id] + " -> " + act_pre_ltlf + ")";
                 agent_pre_ltlf += act_pre_ltlf + " && ";
             }
         }
@@ -388,23 +559,19 @@ namespace Syft {
 
     std::string Domain::get_ltlf_env_pre() const {
         std::string env_pre_ltlf = "";
-        std::unordered_map<std::string, std::string> react_to_legal_acts;
+        // legal actions of each reaction, by reaction id
+        std::vector<std::string> react_to_legal_acts(actions_.reaction_count());
 
         // for each reaction, gets valid actions
-        for (const auto& act : actions_) {
-            std::string env_ltlf = act.get_env_ltlf();
-            if (react_to_legal_acts.find(env_ltlf) == react_to_legal_acts.end())
-                react_to_legal_acts.insert(std::make_pair(std::string(env_ltlf), std::string(act.get_agent_ltlf() + " || ")));
-            else if (react_to_legal_acts.find(env_ltlf) != react_to_legal_acts.end())
-                react_to_legal_acts[env_ltlf] += act.get_agent_ltlf() + " || ";
-        }
+        for (std::size_t row = 0; row < actions_.size(); ++row)
+            react_to_legal_acts[actions_.reaction_id(row)] += agent_ltlfs_[actions_.agent_id(row)] + " || ";
 
-        for (auto& react : react_to_legal_acts) 
-            react_to_legal_acts[react.first] = "(" + react_to_legal_acts[react.first].substr(0, react_to_legal_acts[react.first].size() - 4) + ")";
+        for (auto& legal_acts : react_to_legal_acts)
+            legal_acts = "(" + legal_acts.substr(0, legal_acts.size() - 4) + ")";
 
         // construct env preconditions bdd with results above
-        for (const auto& react_act_ltlf : react_to_legal_acts) {
-            std::string react_pre_ltlf = "((" + react_act_ltlf.first + ") -> (" + react_act_ltlf.second + "))" ;
+        for (std::size_t react_id = 0; react_id < react_to_legal_acts.size(); ++react_id) {
+            std::string react_pre_ltlf = "((" + reaction_ltlfs_[react_id] + ") -> (" + react_to_legal_acts[react_id] + "))" ;
             env_pre_ltlf += react_pre_ltlf + " && "; 
         }
         
@@ -412,57 +579,130 @@ namespace Syft {
         return env_pre_ltlf;   
     }
     
-    SymbolicStateDfa Domain::to_symbolic() {
+    std::size_t Domain::create_variables() {
         // Remember the order of variables
         // (vars, act, react).
 
         // enable dynamic reordering for improving performance
-        var_mgr_->cudd_mgr() -> AutodynEnable();
+        var_mgr_->enable_reordering();
 
         // construct state vars of domain symbolic dfa
-        // vars_.size() are vars, with indexes from 0 to vars_.size() - 1;
+        // state_var_count_ vars encode atoms, with indexes from 0 to state_var_count_ - 1;
         // 2 are agent- and environment-error vars
-        // state var at index vars_.size() is agent-error var
-        // state var at index vars_.size() + 1 is env-error var 
-        std::size_t domain_dfa_id = var_mgr_-> create_state_variables(vars_.size() + 2);
+        // state var at index state_var_count_ is agent-error var
+        // state var at index state_var_count_ + 1 is env-error var 
+        group_state_variables();
+        std::size_t domain_dfa_id = var_mgr_-> create_state_variables(state_var_count_ + 2);
         // std::vector<std::string> domain_dfa_vars = vars_;
         // domain_dfa_vars.push_back("ag_err");
         // domain_dfa_vars.push_back("env_err");
         // std::size_t domain_dfa_id = var_mgr_->create_named_state_variables(domain_dfa_vars);
-        
 
+        atom_bdds_.clear();
+        for (std::size_t i = 0; i < vars_.size(); ++i) {
+            const std::vector<int>& group = state_groups_[atom_groups_[i]];
+            std::size_t offset = group_offsets_[atom_groups_[i]];
+            if (group.size() == 1) {
+                atom_bdds_.push_back(var_mgr_->state_variable(domain_dfa_id, offset));
+                continue;
+            }
+            std::vector<int> code = to_bits(atom_codes_[i], group_offsets_[atom_groups_[i] + 1] - offset);
+            CUDD::BDD atom_bdd = var_mgr_->cudd_mgr()->bddOne();
+            for (std::size_t b = 0; b < code.size(); ++b)
+                atom_bdd = atom_bdd * (code[b] ? var_mgr_->state_variable(domain_dfa_id, offset + b) : !var_mgr_->state_variable(domain_dfa_id, offset + b));
+            atom_bdds_.push_back(atom_bdd);
+        }
+
+        // define input and output vars
+        // store them in var_mgr_. Use create_named_vars, create_input_vars, create_output_vars
+        // assign them to actions (as conjunctions of BDDs)
+        // this function also creates vars with create_named_vars, create_input_vars, create_output_vars
+        Stopwatch builder;
+        builder.start();
+        mutex_axioms_ = get_action_reaction_vars();
+        build_times_.mutex = builder.stop().count() / 1000.0;
+
+        // all variables exist, no BDD over them is built yet
+        bool variable_groups = var_mgr_->reordering_policy().variable_groups;
+        if (var_order_ != VariableOrderHeuristic::Creation || variable_groups || !learned_order_.empty()) apply_variable_order(domain_dfa_id);
+
+        return domain_dfa_id;
+    }
+
+    std::vector<int> Domain::get_dfa_initial_state() const {
         // DFA initial state is as domain's
         // plus two 0's denoting that
         // error vars are false in DFA initial state
-        std::vector<int> dfa_initial_state = init_state_;
+        std::vector<int> dfa_initial_state = get_initial_state_vars();
         dfa_initial_state.push_back(0);
         dfa_initial_state.push_back(0);
+        return dfa_initial_state;
+    }
 
-        // define input and output vars
-        // store them in var_mgr_. Use create_named_vars, create_input_vars, create_output_vars
-        // assign them to actions (as conjunctions of BDDs)
-        std::pair<std::unordered_set<std::string>, std::unordered_set<std::string>> action_reaction_names 
-            = get_action_reaction_names();
+    SymbolicStateDfa Domain::to_symbolic(bool build_transition_function) {
+        std::size_t domain_dfa_id = create_variables();
+        std::vector<int> dfa_initial_state = get_dfa_initial_state();
+        bool variable_groups = var_mgr_->reordering_policy().variable_groups;
 
         // debug
-        // std::cout << "Action names: " << std::endl;
-        // for (const auto& action_name : action_reaction_names.first) std::cout << action_name << std::endl;
-         
-        // std::cout << "Reaction names: " << std::endl;
-        // for (const auto& reaction_name : action_reaction_names.second) std::cout << reaction_name << std::endl;
+        // var_mgr_->print_varmgr();
+        // the cache holds the transition function, final states and
+        // invariants, in this order
+        std::vector<CUDD::BDD> cached_bdds;
+        if (cache_ && cache_->load_bdds(var_mgr_->cudd_mgr(), cached_bdds) && cached_bdds.size() == state_var_count_ + 4) {
+            CUDD::BDD final_states = cached_bdds[state_var_count_ + 2];
+            invariants_bdd_ = cached_bdds[state_var_count_ + 3];
+            cached_bdds.resize(build_transition_function ? state_var_count_ + 2 : 0);
+            if (variable_groups) group_variables(domain_dfa_id);
+            return SymbolicStateDfa(var_mgr_, domain_dfa_id, dfa_initial_state, cached_bdds, final_states);
+        }
 
-        // this function also creates vars with create_named_vars, create_input_vars, create_output_vars
-        auto agent_env_mutex_axioms = get_action_reaction_vars(action_reaction_names.first, action_reaction_names.second);
+        // groups are registered after the variable order is final,
+        // including the order restored from the cache
+        if (variable_groups) group_variables(domain_dfa_id);
 
-        // debug
-        // var_mgr_->print_varmgr();
-        std::vector<CUDD::BDD> transition_function = get_transition_function(domain_dfa_id, agent_env_mutex_axioms.first, agent_env_mutex_axioms.second);
+        // construct a Boolean formula that is SAT if and only if
+        // agent (resp. env) respects action (resp. reaction) preconditions.
+        // Both are only needed by the transition function
+        Stopwatch builder;
+        std::vector<CUDD::BDD> transition_function;
+        if (build_transition_function) {
+            builder.start();
+            CUDD::BDD agent_pre_bdd = get_agent_pre(domain_dfa_id);
+            build_times_.agent_pre = builder.stop().count() / 1000.0;
+
+            builder.start();
+            CUDD::BDD env_pre_bdd = get_env_pre(domain_dfa_id);
+            build_times_.env_pre = builder.stop().count() / 1000.0;
+
+            builder.start();
+            transition_function = get_transition_function(domain_dfa_id, mutex_axioms_.first, mutex_axioms_.second, agent_pre_bdd, env_pre_bdd);
+            build_times_.effects = builder.stop().count() / 1000.0;
+        }
 
+        builder.start();
         CUDD::BDD final_states = get_final_states(domain_dfa_id);
-
-        invariants_bdd_ = var_mgr_->cudd_mgr()->bddOne();
-        for (const auto& inv : invariants_)
-            invariants_bdd_ = invariants_bdd_ * invariant_to_bdd(domain_dfa_id, inv);
+        build_times_.final_states = builder.stop().count() / 1000.0;
+
+        // invariants within a group hold by construction of its codes
+        builder.start();
+        std::vector<CUDD::BDD> invariant_bdds = {get_valid_codes(domain_dfa_id)};
+        for (const auto& inv : invariants_) {
+            bool encoded = inv.get_neg_vars().empty() && !inv.get_pos_vars().empty();
+            int group = encoded ? atom_groups_[*inv.get_pos_vars().begin()] : -1;
+            for (int i : inv.get_pos_vars()) encoded = encoded && atom_groups_[i] == group && state_groups_[group].size() > 1;
+            if (!encoded) invariant_bdds.push_back(invariant_to_bdd(domain_dfa_id, inv));
+        }
+        invariants_bdd_ = conjoin_balanced(var_mgr_->cudd_mgr(), std::move(invariant_bdds));
+        build_times_.invariants = builder.stop().count() / 1000.0;
+
+        // an entry without the transition function is of no use to other engines
+        if (cache_ && build_transition_function) {
+            std::vector<CUDD::BDD> bdds = transition_function;
+            bdds.push_back(final_states);
+            bdds.push_back(invariants_bdd_);
+            cache_->store_bdds(var_mgr_->cudd_mgr(), bdds);
+        }
 
         // debug
         // std::cout << invariants_bdd_ << std::endl;
@@ -478,6 +718,310 @@ namespace Syft {
         return symbolic_dfa;
     }
 
+    std::vector<std::vector<int>> Domain::get_mutex_groups() const {
+        std::vector<std::vector<int>> mutex_groups;
+        std::vector<bool> grouped(vars_.size(), false);
+
+        // atoms of mutex invariants are grouped greedily, largest
+        // invariants first, so that each atom is in at most one group
+        std::vector<std::vector<int>> invariants;
+        for (const auto& inv : invariants_) {
+            if (!inv.get_neg_vars().empty() || inv.get_pos_vars().size() < 2) continue;
+            std::vector<int> atoms(inv.get_pos_vars().begin(), inv.get_pos_vars().end());
+            std::sort(atoms.begin(), atoms.end());
+            invariants.push_back(atoms);
+        }
+        std::sort(invariants.begin(), invariants.end(), [](const std::vector<int>& lhs, const std::vector<int>& rhs) {
+            return lhs.size() != rhs.size() ? lhs.size() > rhs.size() : lhs < rhs;
+        });
+        for (const auto& atoms : invariants) {
+            std::vector<int> free_atoms;
+            for (int i : atoms) if (!grouped[i]) free_atoms.push_back(i);
+            if (free_atoms.size() < 2) continue;
+            for (int i : free_atoms) grouped[i] = true;
+            mutex_groups.push_back(free_atoms);
+        }
+        return mutex_groups;
+    }
+
+    void Domain::group_state_variables() {
+        std::size_t var_count = vars_.size();
+        std::vector<std::vector<int>> mutex_groups;
+        std::vector<int> mutex_group_of(var_count, -1);
+
+        // only log encoding shares state variables among the atoms of a group
+        if (log_encoding_) mutex_groups = get_mutex_groups();
+        for (std::size_t g = 0; g < mutex_groups.size(); ++g)
+            for (int i : mutex_groups[g]) mutex_group_of[i] = g;
+
+        // groups are ordered by their first atom, other atoms are groups of their own
+        state_groups_.clear();
+        atom_groups_.assign(var_count, -1);
+        for (std::size_t i = 0; i < var_count; ++i) {
+            if (atom_groups_[i] >= 0) continue;
+            std::vector<int> group = mutex_group_of[i] < 0 ? std::vector<int>{static_cast<int>(i)} : mutex_groups[mutex_group_of[i]];
+            for (int j : group) atom_groups_[j] = state_groups_.size();
+            state_groups_.push_back(group);
+        }
+
+        // a group has exactly one atom that holds if it does initially,
+        // and every action deleting an atom of the group adds one
+        exactly_one_.assign(state_groups_.size(), false);
+        for (std::size_t g = 0; g < state_groups_.size(); ++g) {
+            if (state_groups_[g].size() < 2) continue;
+            int initially_true = 0;
+            for (int i : state_groups_[g]) initially_true += init_state_[i] == 1;
+            exactly_one_[g] = initially_true == 1;
+        }
+        for (std::size_t row = 0; row < actions_.size(); ++row) {
+            std::vector<int> deleting_groups, adding_groups;
+            for (int i : actions_.delete_list(row)) deleting_groups.push_back(atom_groups_[i]);
+            for (int i : actions_.add_list(row)) adding_groups.push_back(atom_groups_[i]);
+            for (int g : deleting_groups)
+                if (std::find(adding_groups.begin(), adding_groups.end(), g) == adding_groups.end()) exactly_one_[g] = false;
+        }
+
+        // code 0 is left for no atom, unless exactly one atom holds
+        atom_codes_.assign(var_count, 1);
+        group_offsets_.assign(1, 0);
+        for (std::size_t g = 0; g < state_groups_.size(); ++g) {
+            std::size_t size = state_groups_[g].size();
+            for (std::size_t m = 0; m < size; ++m) atom_codes_[state_groups_[g][m]] = exactly_one_[g] ? m : m + 1;
+            group_offsets_.push_back(group_offsets_.back() + get_bits(exactly_one_[g] ? size : size + 1));
+        }
+        state_var_count_ = group_offsets_.back();
+    }
+
+    std::vector<int> Domain::get_initial_state_vars() const {
+        std::vector<int> initial_state;
+        for (std::size_t g = 0; g < state_groups_.size(); ++g) {
+            int code = 0;
+            for (int i : state_groups_[g]) if (init_state_[i] == 1) code = atom_codes_[i];
+            for (int b : to_bits(code, group_offsets_[g + 1] - group_offsets_[g])) initial_state.push_back(b);
+        }
+        return initial_state;
+    }
+
+    std::vector<CUDD::BDD> Domain::get_domain_variables(std::size_t automaton_id) const {
+        std::vector<CUDD::BDD> variables = var_mgr_->get_state_variables(automaton_id);
+        for (const auto& var : action_vars_) variables.push_back(var_mgr_->name_to_variable(var));
+        for (const auto& var : reaction_vars_) variables.push_back(var_mgr_->name_to_variable(var));
+        return variables;
+    }
+
+    std::vector<std::string> Domain::get_domain_variable_names() const {
+        std::vector<std::string> names;
+        for (std::size_t g = 0; g < state_groups_.size(); ++g) {
+            if (state_groups_[g].size() == 1) {
+                names.push_back(vars_[state_groups_[g][0]]);
+                continue;
+            }
+            for (std::size_t v = group_offsets_[g]; v < group_offsets_[g + 1]; ++v)
+                names.push_back(vars_[state_groups_[g][0]] + "/" + std::to_string(v - group_offsets_[g]));
+        }
+        names.push_back("agent_error");
+        names.push_back("env_error");
+        names.insert(names.end(), action_vars_.begin(), action_vars_.end());
+        names.insert(names.end(), reaction_vars_.begin(), reaction_vars_.end());
+        return names;
+    }
+
+    void Domain::save_dfa(std::ostream& out, const SymbolicStateDfa& domain_dfa) const {
+        var_mgr_->save(out);
+        domain_dfa.save(out);
+        BddSerializer::write_magic(out, "SYFTDOM1");
+        BddSerializer::write_uint(out, state_var_count_);
+        BddSerializer::write(out, var_mgr_->cudd_mgr(), {invariants_bdd_});
+    }
+
+    SavedDomainDfa Domain::load_dfa(std::istream& in) {
+        std::shared_ptr<VarMgr> var_mgr = VarMgr::load(in);
+        SymbolicStateDfa dfa = SymbolicStateDfa::load(in, var_mgr);
+        BddSerializer::read_magic(in, "SYFTDOM1");
+        std::size_t state_var_count = BddSerializer::read_uint(in);
+        if (state_var_count + 2 != dfa.initial_state().size()) throw std::runtime_error("Malformed domain DFA stream");
+        std::vector<CUDD::BDD> invariants = BddSerializer::read(in, var_mgr->cudd_mgr());
+        if (invariants.size() != 1) throw std::runtime_error("Malformed domain DFA stream");
+        return SavedDomainDfa {var_mgr, dfa, state_var_count, invariants[0]};
+    }
+
+    void Domain::save_variable_order(std::size_t automaton_id, const std::string& file) const {
+        std::vector<CUDD::BDD> variables = get_domain_variables(automaton_id);
+        std::vector<std::string> names = get_domain_variable_names();
+        std::vector<int> order(variables.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&](int lhs, int rhs) {
+            return var_mgr_->cudd_mgr()->ReadPerm(variables[lhs].NodeReadIndex()) < var_mgr_->cudd_mgr()->ReadPerm(variables[rhs].NodeReadIndex());
+        });
+        std::vector<std::string> ordered_names;
+        for (int v : order) ordered_names.push_back(names[v]);
+        LearnedOrder(ordered_names).save(file);
+    }
+
+    std::vector<std::vector<int>> Domain::get_variable_blocks() const {
+        std::vector<std::vector<int>> blocks;
+        std::size_t action_offset = state_var_count_ + 2;
+        std::size_t reaction_offset = action_offset + action_vars_.size();
+
+        std::vector<int> agent_bits(action_vars_.size());
+        std::iota(agent_bits.begin(), agent_bits.end(), action_offset);
+        blocks.push_back(agent_bits);
+        std::vector<int> reaction_bits(reaction_vars_.size());
+        std::iota(reaction_bits.begin(), reaction_bits.end(), reaction_offset);
+        blocks.push_back(reaction_bits);
+
+        // bits of each log-encoded group, otherwise the atoms of each mutex group
+        if (log_encoding_) {
+            for (std::size_t g = 0; g < state_groups_.size(); ++g) {
+                std::vector<int> group_bits(group_offsets_[g + 1] - group_offsets_[g]);
+                std::iota(group_bits.begin(), group_bits.end(), group_offsets_[g]);
+                if (state_groups_[g].size() > 1) blocks.push_back(group_bits);
+            }
+        } else {
+            for (const auto& group : get_mutex_groups()) blocks.push_back(group);
+        }
+
+        blocks.erase(std::remove_if(blocks.begin(), blocks.end(),
+            [](const std::vector<int>& block) { return block.size() < 2; }), blocks.end());
+        return blocks;
+    }
+
+    void Domain::group_variables(std::size_t automaton_id) const {
+        std::vector<CUDD::BDD> variables = get_domain_variables(automaton_id);
+        for (const auto& block : get_variable_blocks()) {
+            std::vector<CUDD::BDD> group;
+            for (int v : block) group.push_back(variables[v]);
+            var_mgr_->group_variables(group);
+        }
+    }
+
+    void Domain::apply_variable_order(std::size_t automaton_id) const {
+        // variables of the ordering are the state variables, then action bits, then reaction bits
+        std::vector<int> indices;
+        for (const auto& var : get_domain_variables(automaton_id)) indices.push_back(var.NodeReadIndex());
+        std::size_t action_offset = state_var_count_ + 2;
+        std::size_t reaction_offset = action_offset + action_vars_.size();
+
+        // bits of agent actions, and of action-reaction pairs
+        std::vector<int> pair_bits(indices.size() - action_offset);
+        std::iota(pair_bits.begin(), pair_bits.end(), action_offset);
+        std::vector<int> agent_bits(pair_bits.begin(), pair_bits.begin() + (reaction_offset - action_offset));
+
+        // state variables of the group of an atom
+        auto add_atom_vars = [&](int atom, std::vector<int>& vars) {
+            for (std::size_t v = group_offsets_[atom_groups_[atom]]; v < group_offsets_[atom_groups_[atom] + 1]; ++v)
+                vars.push_back(v);
+        };
+
+        VariableOrdering ordering(indices.size());
+        std::vector<bool> added_actions(actions_.agent_count(), false);
+        for (std::size_t row = 0; row < actions_.size(); ++row) {
+            // precondition of the agent action and the agent error var
+            if (!added_actions[actions_.agent_id(row)]) {
+                added_actions[actions_.agent_id(row)] = true;
+                std::vector<int> pre_vars = agent_bits;
+                pre_vars.push_back(state_var_count_);
+                for (int i : actions_.pos_precondition(row)) add_atom_vars(i, pre_vars);
+                for (int i : actions_.neg_precondition(row)) add_atom_vars(i, pre_vars);
+                ordering.add_edge(std::move(pre_vars));
+            }
+            // effects of the action-reaction pair
+            std::vector<int> effect_vars = pair_bits;
+            for (int i : actions_.add_list(row)) add_atom_vars(i, effect_vars);
+            for (int i : actions_.delete_list(row)) add_atom_vars(i, effect_vars);
+            if (effect_vars.size() > pair_bits.size()) ordering.add_edge(std::move(effect_vars));
+        }
+
+        // environment preconditions and the environment error var
+        std::vector<int> env_pre_vars = pair_bits;
+        env_pre_vars.push_back(state_var_count_ + 1);
+        ordering.add_edge(std::move(env_pre_vars));
+
+        std::vector<int> goal_vars;
+        for (int i : pos_goal_list_) add_atom_vars(i, goal_vars);
+        for (int i : neg_goal_list_) add_atom_vars(-i, goal_vars);
+        ordering.add_edge(std::move(goal_vars));
+
+        // mutex atoms and the bits of each group
+        for (const auto& inv : invariants_) {
+            std::vector<int> inv_vars;
+            for (int i : inv.get_pos_vars()) add_atom_vars(i, inv_vars);
+            for (int i : inv.get_neg_vars()) add_atom_vars(i, inv_vars);
+            ordering.add_edge(std::move(inv_vars));
+        }
+        for (std::size_t g = 0; g < state_groups_.size(); ++g) {
+            std::vector<int> group_vars(group_offsets_[g + 1] - group_offsets_[g]);
+            std::iota(group_vars.begin(), group_vars.end(), group_offsets_[g]);
+            ordering.add_edge(std::move(group_vars));
+        }
+
+        std::vector<int> order = ordering.order(var_order_);
+        if (!learned_order_.empty()) order = learned_order_.order(get_domain_variable_names(), order);
+
+        // each block of variables grouped for reordering is moved
+        // to the position of its first variable in order
+        if (var_mgr_->reordering_policy().variable_groups) {
+            std::vector<std::vector<int>> blocks = get_variable_blocks();
+            std::vector<int> block_of(indices.size(), -1);
+            for (std::size_t b = 0; b < blocks.size(); ++b)
+                for (int v : blocks[b]) block_of[v] = b;
+            std::vector<std::vector<int>> block_order(blocks.size());
+            for (int v : order)
+                if (block_of[v] >= 0) block_order[block_of[v]].push_back(v);
+
+            std::vector<int> grouped_order;
+            std::vector<bool> placed(blocks.size(), false);
+            for (int v : order) {
+                int b = block_of[v];
+                if (b < 0) grouped_order.push_back(v);
+                else if (!placed[b]) {
+                    placed[b] = true;
+                    grouped_order.insert(grouped_order.end(), block_order[b].begin(), block_order[b].end());
+                }
+            }
+            order = grouped_order;
+        }
+
+        // the variables keep the set of levels they occupy, so that
+        // variables of other automata in the manager do not move
+        const auto& mgr = var_mgr_->cudd_mgr();
+        std::vector<int> levels;
+        for (int index : indices) levels.push_back(mgr->ReadPerm(index));
+        std::sort(levels.begin(), levels.end());
+
+        std::vector<int> permutation(mgr->ReadSize());
+        for (std::size_t level = 0; level < permutation.size(); ++level) permutation[level] = mgr->ReadInvPerm(level);
+        for (std::size_t k = 0; k < order.size(); ++k) permutation[levels[k]] = indices[order[k]];
+        mgr->ShuffleHeap(permutation.data());
+    }
+
+    CUDD::BDD Domain::get_valid_codes(std::size_t automaton_id) const {
+        CUDD::BDD valid_codes = var_mgr_->cudd_mgr()->bddOne();
+        for (std::size_t g = 0; g < state_groups_.size(); ++g) {
+            std::size_t size = state_groups_[g].size();
+            std::size_t codes = exactly_one_[g] ? size : size + 1;
+            if (size == 1 || codes == (std::size_t(1) << (group_offsets_[g + 1] - group_offsets_[g]))) continue;
+            CUDD::BDD group_codes = var_mgr_->cudd_mgr()->bddZero();
+            for (int i : state_groups_[g]) group_codes = group_codes + atom_bdds_[i];
+            if (!exactly_one_[g]) {
+                CUDD::BDD no_atom = var_mgr_->cudd_mgr()->bddOne();
+                for (std::size_t v = group_offsets_[g]; v < group_offsets_[g + 1]; ++v)
+                    no_atom = no_atom * !var_mgr_->state_variable(automaton_id, v);
+                group_codes = group_codes + no_atom;
+            }
+            valid_codes = valid_codes * group_codes;
+        }
+        return valid_codes;
+    }
+
+    std::vector<std::string> Domain::get_true_atoms(const std::vector<int>& state) const {
+        std::vector<std::string> atoms;
+        std::vector<int> assignment = state;
+        for (std::size_t i = 0; i < vars_.size(); ++i)
+            if (atom_bdds_[i].Eval(assignment.data()).IsOne()) atoms.push_back(vars_[i]);
+        return atoms;
+    }
+
     std::pair<std::unordered_set<int>, std::unordered_set<int>> Domain::get_invariant_vars(const std::vector<std::string>& inv_vec, const std::unordered_map<std::string, int>& var_to_id) const {
         std::pair<std::unordered_set<int>, std::unordered_set<int>> vars;
         std::unordered_set<int> pos_vars;
@@ -494,63 +1038,45 @@ namespace Syft {
     }
 
     CUDD::BDD Domain::invariant_to_bdd(std::size_t automaton_id, const Invariant& inv) const {
-        CUDD::BDD inv_bdd(var_mgr_->cudd_mgr()->bddOne());
-        std::vector<CUDD::BDD> state_vars = var_mgr_->get_state_variables(automaton_id);
-        std::unordered_set<int> inv_pos_vars = inv.get_pos_vars();
-        std::unordered_set<int> inv_neg_vars = inv.get_neg_vars();
-
-        // mutex for pos vars
-        for (const auto& var : inv_pos_vars) {
-            CUDD::BDD mutex(var_mgr_->cudd_mgr()->bddOne());
-            for (const auto& var_prime : inv_pos_vars)
-                if (var_prime != var) mutex = mutex * (!state_vars[var_prime]);
-            for (const auto& var_prime_prime : inv_neg_vars) 
-                mutex = mutex * state_vars[var_prime_prime];
-            inv_bdd = inv_bdd * ((!state_vars[var]) + mutex);
-        }
-
-        // mutex for neg vars
-        for (const auto& var : inv_neg_vars) {
-            CUDD::BDD mutex(var_mgr_->cudd_mgr()->bddOne());
-            for (const auto& var_prime : inv_pos_vars)
-                mutex = mutex * (!state_vars[var_prime]);
-            for (const auto& var_prime_prime: inv_neg_vars)
-                if (var_prime_prime != var) mutex = mutex * (state_vars[var_prime_prime]);
-            inv_bdd = inv_bdd * ((!state_vars[var]) + mutex);
+        // literals of the invariant, at most one of which holds
+        std::vector<CUDD::BDD> literals;
+        for (int var : inv.get_pos_vars()) literals.push_back(atom_bdds_[var]);
+        for (int var : inv.get_neg_vars()) literals.push_back(!atom_bdds_[var]);
+
+        // literals are added from the bottom of the variable order up,
+        // so that each step only puts a node on top of the two BDDs and,
+        // with one state variable per atom, the result has at most two
+        // nodes per literal
+        auto level = [&](const CUDD::BDD& literal) {
+            return var_mgr_->cudd_mgr()->ReadPerm(literal.NodeReadIndex());
+        };
+        std::sort(literals.begin(), literals.end(), [&](const CUDD::BDD& lhs, const CUDD::BDD& rhs) {
+            return level(lhs) > level(rhs);
+        });
+
+        // sequential encoding: none holds if no literal added so far is true,
+        // at_most_one if at most one is
+        CUDD::BDD none = var_mgr_->cudd_mgr()->bddOne();
+        CUDD::BDD at_most_one = var_mgr_->cudd_mgr()->bddOne();
+        for (const auto& literal : literals) {
+            at_most_one = literal.Ite(none, at_most_one);
+            none = none * !literal;
         }
 
         // debug
-        // std::cout << "Invariant BDD: " << inv_bdd << std::endl;
-        return inv_bdd;
+        // std::cout << "Invariant BDD: " << at_most_one << std::endl;
+        return at_most_one;
     }
 
-    std::pair<std::unordered_set<std::string>, std::unordered_set<std::string>> Domain::get_action_reaction_names() const {
-        auto action_reaction_names = std::make_pair(std::unordered_set<std::string>(), std::unordered_set<std::string>());
-
-        for (const auto& act: actions_) {
-            std::string action_reaction_name = act.get_action_name();
-
-            // finds where action and reaction name splits
-            int split_index = action_reaction_name.find("_REACT");
-
-            std::string reaction_name = action_reaction_name.substr(split_index);
-            std::string action_name = boost::replace_all_copy(action_reaction_name, reaction_name, "");
-
-            action_reaction_names.first.insert(action_name);
-            action_reaction_names.second.insert(reaction_name);
-        }
-        return action_reaction_names;
-    }
-
-    std::size_t Domain::get_bits(const std::unordered_set<std::string>& set) const {
-        std::size_t count = 0;
-        std::size_t size = set.size() - 1;
+    std::size_t Domain::get_bits(std::size_t count) const {
+        std::size_t bits = 0;
+        std::size_t size = count - 1;
         if (size == 0) return 1;
         while (size) {
-            ++count;
+            ++bits;
             size>>=1; 
         }
-        return count;
+        return bits;
     }
 
     std::vector<int> Domain::to_bits(int i, std::size_t size) const {
@@ -567,11 +1093,11 @@ namespace Syft {
             return bin;
     }
 
-    std::pair<CUDD::BDD, CUDD::BDD> Domain::get_action_reaction_vars(const std::unordered_set<std::string>& action_names, const std::unordered_set<std::string>& reaction_names) {
+    std::pair<CUDD::BDD, CUDD::BDD> Domain::get_action_reaction_vars() {
 
         // create and partition input and output vars
-        std::size_t action_bits = get_bits(action_names);
-        std::size_t reaction_bits = get_bits(reaction_names);
+        std::size_t action_bits = get_bits(actions_.agent_count());
+        std::size_t reaction_bits = get_bits(actions_.reaction_count());
 
         // debug
         // std::cout << "Bits for action vars: " << action_bits << std::endl;
@@ -608,20 +1134,17 @@ namespace Syft {
         // var_mgr_->print_varmgr();
 
         // define encoding for action and reaction vars
-        std::unordered_map<std::string, CUDD::BDD> action_name_to_bdd;
-        std::unordered_map<std::string, CUDD::BDD> reaction_name_to_bdd;
-        // std::unordered_map<std::string, std::vector<int>> action_name_to_bin;
-        // std::unordered_map<std::string, std::vector<int>> reaction_name_to_bin;
-
-        // mutual exlcusion axioms for agent and environment
-        CUDD::BDD agent_mutex = var_mgr_->cudd_mgr()->bddZero();
-        CUDD::BDD env_mutex = var_mgr_->cudd_mgr()->bddZero();
+        agent_bdds_.clear();
+        reaction_bdds_.clear();
 
         // encode agent actions and env reactions in binary
         // leftmost bit -> least significant; rightmost bit -> most significant
+        // the code of each action (resp. reaction) is its id in actions_,
+        // i.e. names are encoded in lexicographic order, so that the encoding
+        // only depends on the task, e.g. for DFAs in DomainCache
+
         // std::cout << "encoding agent acts..." << std::flush;
-        int act_int_id = 0, react_int_id = 0;
-        for (const auto& action_name : action_names) {
+        for (int act_int_id = 0; act_int_id < actions_.agent_count(); ++act_int_id) {
             std::vector<int> act_bin_id = to_bits(act_int_id, action_bits);
             // debug
             // std::cout << "Current action name: " << action_name << ". Action ID: " << act_int_id;
@@ -633,15 +1156,12 @@ namespace Syft {
                 if (act_bin_id[i] == 1) act_bdd = act_bdd * var_mgr_->name_to_variable("a_"+std::to_string(i));
                 else if (act_bin_id[i] == 0) act_bdd = act_bdd * !(var_mgr_->name_to_variable("a_"+std::to_string(i)));
             }
-            action_name_to_bdd.insert(std::make_pair(action_name, act_bdd));
-            // action_name_to_bin.insert(std::make_pair(action_name, act_bin_id));
-            agent_mutex = agent_mutex + act_bdd; // add action bdd to mutual exclusion agent axiom
-            id_to_action_name_.insert(std::make_pair(act_int_id, action_name));
-            ++act_int_id; 
+            agent_bdds_.push_back(act_bdd);
+            id_to_action_name_.insert(std::make_pair(act_int_id, actions_.agent_name(act_int_id)));
         }
         // std::cout << "Done!" << std::flush;
 
-        for (const auto& reaction_name : reaction_names) {
+        for (int react_int_id = 0; react_int_id < actions_.reaction_count(); ++react_int_id) {
             std::vector<int> react_bin_id = to_bits(react_int_id, reaction_bits);
             CUDD::BDD react_bdd = var_mgr_->cudd_mgr()->bddOne();
             // debug
@@ -653,57 +1173,13 @@ namespace Syft {
                 if (react_bin_id[i] == 1) react_bdd = react_bdd * var_mgr_->name_to_variable("r_"+std::to_string(i));
                 else if (react_bin_id[i] == 0) react_bdd = react_bdd * !(var_mgr_->name_to_variable("r_"+std::to_string(i)));
             }
-            reaction_name_to_bdd.insert(std::make_pair(reaction_name, react_bdd));
-            // reaction_name_to_bin.insert(std::make_pair(reaction_name, react_bin_id));
-            env_mutex = env_mutex + react_bdd; // add reaction bdd to mutual exclusion env axiom
-            id_to_reaction_name_.insert(std::make_pair(react_int_id, reaction_name));
-            ++react_int_id;
+            reaction_bdds_.push_back(react_bdd);
+            id_to_reaction_name_.insert(std::make_pair(react_int_id, actions_.reaction_name(react_int_id)));
         }
 
-        // debug
-        // std::cout << "(ACTION NAME: BDD): " << std::endl;
-        // for (const auto& pair: action_name_to_bdd) {
-            // std::cout << pair.first << ": " << pair.second << std::endl;
-        // }
-
-        // std::cout << "(REACTION NAME, BDD): " << std::endl;
-        // for (const auto& pair: reaction_name_to_bdd) {
-            // std::cout << pair.first << ": " << pair.second << std::endl;
-        // }
-
-        // assign encoding to action_reaction_names
-        // TODO. this code is a little bit inefficient
-        // creates a new set of actions and substitute it
-        // with the existing one. Can we avoid it?
-        std::unordered_set<Action, ActionHash> updated_actions;
-        for (Action act : actions_) {
-            // std::cout << "Encoding action: " << act.get_action_name() << std::endl;
-
-            std::string action_reaction_name = act.get_action_name();
-
-            // finds where action and reaction name splits
-            int split_index = action_reaction_name.find("_REACT");
-
-            std::string reaction_name = action_reaction_name.substr(split_index);
-            std::string action_name = boost::replace_all_copy(action_reaction_name, reaction_name, "");
-
-            act.set_agent_bdd(action_name_to_bdd[action_name]);
-            act.set_env_bdd(reaction_name_to_bdd[reaction_name]);
-            act.set_action_bdd(action_name_to_bdd[action_name] * reaction_name_to_bdd[reaction_name]);
-
-            // act.set_action_bin(action_name_to_bin[action_name]);
-            // act.set_env_bin(reaction_name_to_bin[reaction_name]);
-
-            updated_actions.insert(act);
-        }
-
-        actions_ = updated_actions;
-
-        // debug
-        // std::cout << "(ACTION-REACTION: BDD)" << std::endl;
-        // for (const auto& act: actions_) {
-            // std::cout << act.get_action_name() << ": " << act.get_action_bdd() << std::endl; 
-        // }
+        // mutual exlcusion axioms for agent and environment
+        CUDD::BDD agent_mutex = disjoin_balanced(var_mgr_->cudd_mgr(), agent_bdds_);
+        CUDD::BDD env_mutex = disjoin_balanced(var_mgr_->cudd_mgr(), reaction_bdds_);
 
         // debug
         // std::cout << "Agent mutex axiom: " << agent_mutex << std::endl;
@@ -712,41 +1188,62 @@ namespace Syft {
         return std::make_pair(CUDD::BDD(agent_mutex), CUDD::BDD(env_mutex));
     }
 
-    std::vector<CUDD::BDD> Domain::get_transition_function(std::size_t automaton_id, const CUDD::BDD& agent_mutex, const CUDD::BDD& env_mutex) const {
+    std::vector<CUDD::BDD> Domain::get_transition_function(std::size_t automaton_id, const CUDD::BDD& agent_mutex, const CUDD::BDD& env_mutex, const CUDD::BDD& agent_pre_bdd, const CUDD::BDD& env_pre_bdd) const {
 
         std::vector<CUDD::BDD> transition_function;
+        const auto& mgr = var_mgr_->cudd_mgr();
 
-        // auxiliar vectors to construct add and delete bdds
-        std::vector<CUDD::BDD> add_bdds(vars_.size(), var_mgr_->cudd_mgr()->bddZero());
-        std::vector<CUDD::BDD> del_bdds(vars_.size(), var_mgr_->cudd_mgr()->bddZero());
+        // action-reaction pairs that add and delete each var
+        std::vector<std::vector<CUDD::BDD>> add_pairs(vars_.size());
+        std::vector<std::vector<CUDD::BDD>> del_pairs(vars_.size());
 
         // assign actions to add and del bdds of vars
         // std::cout << "collecting action-reaction add- and delete-lists..." << std::flush;
-        for (const auto& act : actions_) {
-            auto act_add_list = act.get_add_list();
-            auto act_del_list = act.get_del_list(); 
-            for (const auto& id : act_add_list) {
-                // debug
-                // std::cout << "Action: " << act.get_action_name() << ". Added to var " << id << " BDD add list" << std::endl;
-                add_bdds[id] = add_bdds[id] + act.get_action_bdd();
-            }
-            for (const auto& id : act_del_list) {
-                // debug
-                // std::cout << "Action: " << act.get_action_name() << ". Added to var " << id << " BDD del list" << std::endl;
-                del_bdds[id] = del_bdds[id] + act.get_action_bdd();
-            }
+        for (std::size_t row = 0; row < actions_.size(); ++row) {
+            if (actions_.add_list(row).size() == 0 && actions_.delete_list(row).size() == 0) continue;
+            CUDD::BDD act_bdd = agent_bdds_[actions_.agent_id(row)] * reaction_bdds_[actions_.reaction_id(row)];
+            for (int id : actions_.add_list(row)) add_pairs[id].push_back(act_bdd);
+            for (int id : actions_.delete_list(row)) del_pairs[id].push_back(act_bdd);
+        }
+
+        // auxiliar vectors to construct add and delete bdds
+        std::vector<CUDD::BDD> add_bdds, del_bdds;
+        for (std::size_t id = 0; id < vars_.size(); ++id) {
+            add_bdds.push_back(disjoin_balanced(mgr, std::move(add_pairs[id])));
+            del_bdds.push_back(disjoin_balanced(mgr, std::move(del_pairs[id])));
         }
         // std::cout << "DONE!" << std::endl;
 
         // construct bdds in transition function
         // std::cout << "constructing BDDs of vars in transition function... " << std::flush;
-        for (int i = 0; i < vars_.size(); ++i) {
-            CUDD::BDD var_bdd = 
-                ((var_mgr_->state_variable(automaton_id, i) * !(del_bdds[i])) +
-                (add_bdds[i]));
-            transition_function.push_back(var_bdd);
-            // debug
-            // std::cout << "Variable: " << i << ". BDD: " << var_bdd << std::endl; 
+        for (std::size_t g = 0; g < state_groups_.size(); ++g) {
+            const std::vector<int>& group = state_groups_[g];
+            if (group.size() == 1) {
+                int i = group[0];
+                CUDD::BDD var_bdd = 
+                    ((atom_bdds_[i] * !(del_bdds[i])) +
+                    (add_bdds[i]));
+                transition_function.push_back(var_bdd);
+                // debug
+                // std::cout << "Variable: " << i << ". BDD: " << var_bdd << std::endl; 
+                continue;
+            }
+
+            // the code of an added atom wins. Otherwise, the group keeps
+            // its code unless the atom that holds is deleted, and goes to 0
+            std::vector<CUDD::BDD> group_adds, group_dels;
+            for (int i : group) {
+                group_adds.push_back(add_bdds[i]);
+                group_dels.push_back(del_bdds[i] * atom_bdds_[i]);
+            }
+            CUDD::BDD keep = (!disjoin_balanced(mgr, std::move(group_adds))) * (!disjoin_balanced(mgr, std::move(group_dels)));
+            for (std::size_t v = group_offsets_[g]; v < group_offsets_[g + 1]; ++v) {
+                std::vector<CUDD::BDD> set_adds;
+                for (int i : group)
+                    if ((atom_codes_[i] >> (v - group_offsets_[g])) & 1) set_adds.push_back(add_bdds[i]);
+                CUDD::BDD set = disjoin_balanced(mgr, std::move(set_adds));
+                transition_function.push_back(set + (keep * var_mgr_->state_variable(automaton_id, v)));
+            }
         }
         // std::cout << "DONE!" << std::endl;
 
@@ -754,26 +1251,16 @@ namespace Syft {
         // std::cout << "Agent mutex BDD: " << agent_mutex << std::endl;
         // std::cout << "Env mutex BDD: " << env_mutex << std::endl;
 
-        // construct a Boolean formula that is SAT if and only if
-        // agent (resp. env) respects action (resp. reaction) preconditions
-        // std::cout << "Computing agent error BDD... " << std::flush;
-        CUDD::BDD agent_pre_bdd = get_agent_pre(automaton_id);
-        // std::cout << "DONE!" << std::endl;
-        // std::cout << "Computing environment error BDD..." << std::flush;
-        CUDD::BDD env_pre_bdd = get_env_pre(automaton_id);
-        // std::cout << "DONE!" << std::endl;
-        
-        
         // agent reaches error state if, and only if:
         // 1. was previously in agent error state; or
         // 2. violated mutex for agent actions; or
         // 3. violated action preconditions
-        CUDD::BDD agent_err_bdd = (var_mgr_->state_variable(automaton_id, vars_.size()))  + (!agent_mutex) + (!agent_pre_bdd);
+        CUDD::BDD agent_err_bdd = (var_mgr_->state_variable(automaton_id, state_var_count_))  + (!agent_mutex) + (!agent_pre_bdd);
         // environment reaches error state if, and only if:
         // 1. was previously in environment error state; or
         // 2. violated mutex for environment reactions; or
         // 3. violated reaction preconditions
-        CUDD::BDD env_err_bdd = (var_mgr_->state_variable(automaton_id, vars_.size() + 1)) + (!env_mutex) + (!env_pre_bdd);
+        CUDD::BDD env_err_bdd = (var_mgr_->state_variable(automaton_id, state_var_count_ + 1)) + (!env_mutex) + (!env_pre_bdd);
     
         transition_function.push_back(agent_err_bdd);
         transition_function.push_back(env_err_bdd);
@@ -782,77 +1269,132 @@ namespace Syft {
     }
 
     CUDD::BDD Domain::get_agent_pre(std::size_t domain_dfa_id) const {
-        CUDD::BDD agent_pre_bdd = var_mgr_->cudd_mgr()->bddOne();
-        std::unordered_set<std::string> added_action_names;
+        std::vector<CUDD::BDD> act_pre_bdds;
+        // all reactions to an action share its precondition,
+        // which is added once from the first of its rows
+        std::vector<bool> added_actions(actions_.agent_count(), false);
         // debug
         // std::cout << "Number of agent-reaction: " << actions_.size() << std::endl;
-        int i = 0;
-        for (const auto& act: actions_) {
-            std::string action_reaction_name = act.get_action_name();
-            // debug 
-            // std::cout << "Current action-reaction number: " << i << ". Name: " << action_reaction_name << std::endl;
-
-            int split_index = action_reaction_name.find("_REACT");
+        for (std::size_t row = 0; row < actions_.size(); ++row) {
+            int agent_id = actions_.agent_id(row);
 
-            std::string reaction_name = action_reaction_name.substr(split_index);
-            std::string action_name = boost::replace_all_copy(action_reaction_name, reaction_name, "");
-
-            if (added_action_names.find(action_name) == added_action_names.end()) { // action name has not been added to agent pre
+            if (!added_actions[agent_id]) { // action has not been added to agent pre
                 // debug
                 // std::cout << "Action not processed. Adding to preconditions..." << std::flush;
 
-                added_action_names.insert(action_name);
+                added_actions[agent_id] = true;
 
-                auto act_pos_pre = act.get_pos_pre();
-                auto act_neg_pre = act.get_neg_pre();
                 CUDD::BDD act_pre_bdd = var_mgr_->cudd_mgr()->bddOne();
-                for (const auto& i : act_pos_pre) act_pre_bdd = act_pre_bdd * var_mgr_->state_variable(domain_dfa_id, i);
-                for (const auto& i : act_neg_pre) act_pre_bdd = act_pre_bdd * (!var_mgr_->state_variable(domain_dfa_id, -i));
+                for (int i : actions_.pos_precondition(row)) act_pre_bdd = act_pre_bdd * atom_bdds_[i];
+                for (int i : actions_.neg_precondition(row)) act_pre_bdd = act_pre_bdd * (!atom_bdds_[i]);
 
-                act_pre_bdd = ((!act.get_agent_bdd()) + act_pre_bdd);
-                agent_pre_bdd = agent_pre_bdd * act_pre_bdd;
+                act_pre_bdds.push_back((!agent_bdds_[agent_id]) + act_pre_bdd);
                 // std::cout << "Done!" << std::endl;
 
                 // var_mgr_-> cudd_mgr() -> ReduceHeap(); // shrinks size of BDDs    
             }
-            // auto act_pos_pre = act.get_pos_pre();
-            // auto act_neg_pre = act.get_neg_pre();
-            // CUDD::BDD act_pre_bdd = var_mgr_->cudd_mgr()->bddOne();
-            // for (const auto& i : act_pos_pre) act_pre_bdd = act_pre_bdd * var_mgr_->state_variable(domain_dfa_id, i);
-            // for (const auto& i : act_neg_pre) act_pre_bdd = act_pre_bdd * (!var_mgr_->state_variable(domain_dfa_id, -i));
-            // act_pre_bdd = ((!act.get_action_bdd()) + act_pre_bdd); // implements function act -> pre(act)
-            // act_pre_bdd = ((!act.get_agent_bdd()) + act_pre_bdd);
-            // agent_pre_bdd = agent_pre_bdd * act_pre_bdd;
-            ++i;
         }
-        return agent_pre_bdd;
+        return conjoin_balanced(var_mgr_->cudd_mgr(), std::move(act_pre_bdds));
     }
 
     CUDD::BDD Domain::get_env_pre(std::size_t domain_dfa_id) const {
-        CUDD::BDD env_pre_bdd = var_mgr_->cudd_mgr()->bddOne();
-        std::unordered_map<CUDD::BDD, CUDD::BDD, BDDHash> react_to_legal_acts;
+        // legal actions of each reaction, by reaction id
+        std::vector<std::vector<CUDD::BDD>> react_to_legal_acts(actions_.reaction_count());
 
         // for each reaction, gets valid actions
-        for (const auto& act : actions_) {
-            CUDD::BDD env_bdd = act.get_env_bdd();
-            if (react_to_legal_acts.find(env_bdd) == react_to_legal_acts.end())
-                react_to_legal_acts.insert(std::make_pair(CUDD::BDD(env_bdd), CUDD::BDD(act.get_agent_bdd())));
-            else if (react_to_legal_acts.find(env_bdd) != react_to_legal_acts.end())
-                react_to_legal_acts[env_bdd] = react_to_legal_acts[env_bdd] + act.get_agent_bdd();
-        }
+        for (std::size_t row = 0; row < actions_.size(); ++row)
+            react_to_legal_acts[actions_.reaction_id(row)].push_back(agent_bdds_[actions_.agent_id(row)]);
 
         // construct env preconditions bdd with results above
-        for (const auto& react_act_bdd : react_to_legal_acts) {
-            CUDD::BDD react_pre_bdd = ((!(react_act_bdd.first)) + react_act_bdd.second);
-            env_pre_bdd = env_pre_bdd * react_pre_bdd;
+        std::vector<CUDD::BDD> react_pre_bdds;
+        for (std::size_t react_id = 0; react_id < react_to_legal_acts.size(); ++react_id) {
+            CUDD::BDD legal_acts = disjoin_balanced(var_mgr_->cudd_mgr(), std::move(react_to_legal_acts[react_id]));
+            react_pre_bdds.push_back((!reaction_bdds_[react_id]) + legal_acts);
+        }
+        return conjoin_balanced(var_mgr_->cudd_mgr(), std::move(react_pre_bdds));
+    }
+
+    std::vector<ActionPartition> Domain::get_action_partitions(std::size_t automaton_id) const {
+        // effects are cubes over the variables of atoms
+        if (log_encoding_) throw std::runtime_error("Transitions partitioned per agent action require one state variable per atom");
+
+        // partitions are indexed by agent action id
+        std::vector<ActionPartition> partitions(actions_.agent_count());
+        std::vector<std::size_t> agent_reactions(actions_.agent_count(), 0);
+
+        for (std::size_t row = 0; row < actions_.size(); ++row) {
+            int agent_id = actions_.agent_id(row);
+            ActionPartition& partition = partitions[agent_id];
+            if (agent_reactions[agent_id]++ == 0) {
+                // all reactions to an action share its precondition
+                partition.agent_bdd = agent_bdds_[agent_id];
+                partition.precondition = var_mgr_->cudd_mgr()->bddOne();
+                for (int i : actions_.pos_precondition(row)) partition.precondition = partition.precondition * var_mgr_->state_variable(automaton_id, i);
+                for (int i : actions_.neg_precondition(row)) partition.precondition = partition.precondition * (!var_mgr_->state_variable(automaton_id, i));
+            }
+
+            // as in the transition function, add-list wins over delete-list
+            FluentRange act_add_list = actions_.add_list(row);
+            CUDD::BDD effect = var_mgr_->cudd_mgr()->bddOne();
+            for (int i : act_add_list) effect = effect * var_mgr_->state_variable(automaton_id, i);
+            for (int i : actions_.delete_list(row))
+                if (!act_add_list.contains(i)) effect = effect * (!var_mgr_->state_variable(automaton_id, i));
+
+            std::vector<CUDD::BDD>& effects = partition.effects;
+            if (std::find(effects.begin(), effects.end(), effect) == effects.end()) effects.push_back(effect);
         }
-        return env_pre_bdd;
+
+        // reaction codes not assigned to a legal reaction lead to the env error
+        std::size_t reaction_codes = 1 << reaction_vars_.size();
+        for (std::size_t agent_id = 0; agent_id < partitions.size(); ++agent_id)
+            partitions[agent_id].illegal_reactions = agent_reactions[agent_id] < reaction_codes;
+        return partitions;
+    }
+
+    std::vector<ExplicitActionPartition> Domain::get_explicit_action_partitions() const {
+        // explicit states are indexed by atoms
+        if (log_encoding_) throw std::runtime_error("Explicit action partitions require one state variable per atom");
+
+        // partitions are indexed by agent action id
+        std::vector<ExplicitActionPartition> partitions(actions_.agent_count());
+        std::vector<bool> has_precondition(actions_.agent_count(), false);
+
+        for (std::size_t row = 0; row < actions_.size(); ++row) {
+            int agent_id = actions_.agent_id(row);
+            ExplicitActionPartition& partition = partitions[agent_id];
+            if (!has_precondition[agent_id]) {
+                // all reactions to an action share its precondition
+                has_precondition[agent_id] = true;
+                partition.agent_bdd = agent_bdds_[agent_id];
+                for (int i : actions_.pos_precondition(row)) partition.pos_precondition.push_back(i);
+                for (int i : actions_.neg_precondition(row)) partition.neg_precondition.push_back(i);
+            }
+
+            // as in the transition function, add-list wins over delete-list.
+            // Fluent lists of the table are sorted
+            FluentRange act_add_list = actions_.add_list(row);
+            std::vector<std::size_t> add_list(act_add_list.begin(), act_add_list.end());
+            std::vector<std::size_t> delete_list;
+            for (int i : actions_.delete_list(row))
+                if (!act_add_list.contains(i)) delete_list.push_back(i);
+
+            bool duplicate = false;
+            for (std::size_t k = 0; k < partition.add_lists.size(); ++k)
+                if (partition.add_lists[k] == add_list && partition.delete_lists[k] == delete_list) duplicate = true;
+            if (!duplicate) {
+                partition.add_lists.push_back(add_list);
+                partition.delete_lists.push_back(delete_list);
+            }
+        }
+
+        return partitions;
     }
 
     CUDD::BDD Domain::get_final_states(std::size_t domain_dfa_id) const {
-        CUDD::BDD final_states = var_mgr_->cudd_mgr()->bddOne();
-        for (const auto& i : pos_goal_list_) final_states = final_states * var_mgr_->state_variable(domain_dfa_id, i);
-        for (const auto& i : neg_goal_list_) final_states = final_states * !(var_mgr_->state_variable(domain_dfa_id, -i));
+        std::vector<CUDD::BDD> goal_bdds;
+        for (const auto& i : pos_goal_list_) goal_bdds.push_back(atom_bdds_[i]);
+        for (const auto& i : neg_goal_list_) goal_bdds.push_back(!(atom_bdds_[-i]));
+        CUDD::BDD final_states = conjoin_balanced(var_mgr_->cudd_mgr(), std::move(goal_bdds));
         // return only final states without agent or error vars
         // agent or error vars are included depending on the game to be solved
         // i.e., adversarial vs. cooperative
@@ -886,16 +1428,15 @@ namespace Syft {
             for (const auto& v : state) std::cout << v;
             std::cout << std::endl;
             std::string string_state = "{";
-            for (int i = 0; i < vars_.size(); ++i)
-                if (state[i] == 1) string_state += vars_[i] + ", ";
+            for (const auto& atom : get_true_atoms(state)) string_state += atom + ", ";
             string_state = string_state.substr(0, string_state.size() - 2) + "}";
             std::cout << "[pddl2dfa] State vars: " << string_state << std::endl; 
             
 
             std::cout << "[pddl2dfa] The current state is: ";
-            if (var_mgr_->state_variable(domain_dfa_.automaton_id(), vars_.size()).Eval(state.data()).IsOne())
+            if (var_mgr_->state_variable(domain_dfa_.automaton_id(), state_var_count_).Eval(state.data()).IsOne())
                 std::cout << "- AGENT ERROR STATE -";
-            if (var_mgr_->state_variable(domain_dfa_.automaton_id(), vars_.size()+1).Eval(state.data()).IsOne())
+            if (var_mgr_->state_variable(domain_dfa_.automaton_id(), state_var_count_+1).Eval(state.data()).IsOne())
                 std::cout << "- ENVIRONMENT ERROR STATE -";
             if (final_states.Eval(state.data()).IsOne()) std::cout << "- FINAL -";
             else std::cout << "- NOT FINAL -";
@@ -963,7 +1504,7 @@ namespace Syft {
 
         std::cout << "Number of action-reaction pairs: " << actions_.size() << std::endl;
         std::cout << std::endl;
-        for (auto const& act : actions_) {act.print(); std::cout << std::endl;}
+        for (std::size_t row = 0; row < actions_.size(); ++row) {actions_.print(row); std::cout << std::endl;}
 
         std::cout << "Number of invariants: " << invariants_.size() << std::endl;
         std::cout << std::endl;
@@ -0,0 +1,178 @@
+/*
+* Definition of class DomainCache
+*/
+
+#include"DomainCache.h"
+
+#include<cstdlib>
+#include<fstream>
+#include<iomanip>
+#include<sstream>
+#include<stdexcept>
+#include<system_error>
+#include<unistd.h>
+#include"BddSerializer.h"
+
+namespace Syft {
+
+    // bumped whenever the format of an entry changes
+    static const std::string cache_format = "2";
+
+    DomainCache::DomainCache(
+        const std::string& cache_dir,
+        const std::string& domain_file,
+        const std::string& problem_file,
+        const std::string& options
+    ) {
+        // FNV-1a of the contents, stable across runs and platforms
+        std::uint64_t key = 14695981039346656037ULL;
+        key = hash(cache_format, key);
+        key = hash(read_file(domain_file), key);
+        key = hash(read_file(problem_file), key);
+        key = hash(options, key);
+
+        std::ostringstream entry_name;
+        entry_name << std::hex << std::setw(16) << std::setfill('0') << key;
+        entry_ = std::filesystem::path(cache_dir) / entry_name.str();
+    }
+
+    std::uint64_t DomainCache::hash(const std::string& data, std::uint64_t seed) {
+        // fields are separated by a zero byte, so that their
+        // boundaries are part of the key
+        for (unsigned char c : data) seed = (seed ^ c) * 1099511628211ULL;
+        return (seed ^ 0) * 1099511628211ULL;
+    }
+
+    std::string DomainCache::read_file(const std::string& file) {
+        std::ifstream input_stream(file, std::ios::binary);
+        if (!input_stream) throw std::runtime_error("Unable to read " + file);
+        std::ostringstream contents;
+        contents << input_stream.rdbuf();
+        return contents.str();
+    }
+
+    void DomainCache::store(const std::string& name, const std::string& data) const {
+        std::filesystem::create_directories(entry_);
+        // mkstemp gives each writer its own file, also across the threads
+        // of a portfolio sharing the process
+        std::string tmp = (entry_ / (name + ".tmp-XXXXXX")).string();
+        int fd = mkstemp(tmp.data());
+        if (fd == -1) throw std::runtime_error("Unable to create cache file " + tmp);
+        std::size_t written = 0;
+        while (written < data.size()) {
+            ssize_t n = write(fd, data.data() + written, data.size() - written);
+            if (n <= 0) break;
+            written += n;
+        }
+        if (close(fd) != 0 || written < data.size()) {
+            std::filesystem::remove(tmp);
+            throw std::runtime_error("Unable to write cache file " + tmp);
+        }
+        // a failed rename means another writer got there first, or removed
+        // the entry, and its copy is as good as this one
+        std::error_code error;
+        std::filesystem::rename(tmp, entry_ / name, error);
+        if (error) std::filesystem::remove(tmp, error);
+    }
+
+    bool DomainCache::load_task(GroundTask& task) const {
+        std::ifstream input_stream(entry_ / "task.txt");
+        if (!input_stream) return false;
+
+        GroundTask cached;
+        std::string line;
+        std::size_t count;
+
+        input_stream >> count;
+        std::getline(input_stream, line);
+        cached.atoms.resize(count);
+        for (auto& atom : cached.atoms) std::getline(input_stream, atom);
+
+        input_stream >> count;
+        cached.init.resize(count);
+        for (auto& value : cached.init) input_stream >> value;
+
+        input_stream >> count;
+        cached.goal.resize(count);
+        for (auto& goal : cached.goal) input_stream >> goal.first >> goal.second;
+
+        input_stream >> count;
+        cached.operators.resize(count);
+        for (auto& op : cached.operators) {
+            std::getline(input_stream, line);
+            std::getline(input_stream, op.name);
+            input_stream >> count;
+            op.prevail.resize(count);
+            for (auto& prevail : op.prevail) input_stream >> prevail.first >> prevail.second;
+            input_stream >> count;
+            op.pre_post.resize(count);
+            for (auto& pre_post : op.pre_post)
+                input_stream >> std::get<0>(pre_post) >> std::get<1>(pre_post) >> std::get<2>(pre_post);
+        }
+
+        // one invariant per line, atoms separated by ';'
+        input_stream >> count;
+        std::getline(input_stream, line);
+        cached.invariants.resize(count);
+        for (auto& invariant : cached.invariants) {
+            std::getline(input_stream, line);
+            std::istringstream atoms(line);
+            std::string atom;
+            while (std::getline(atoms, atom, ';')) invariant.push_back(atom);
+        }
+
+        if (!input_stream) return false;
+        task = std::move(cached);
+        return true;
+    }
+
+    void DomainCache::store_task(const GroundTask& task) const {
+        std::ostringstream output_stream;
+        output_stream << task.atoms.size() << "\n";
+        for (const auto& atom : task.atoms) output_stream << atom << "\n";
+
+        output_stream << task.init.size();
+        for (int value : task.init) output_stream << " " << value;
+        output_stream << "\n";
+
+        output_stream << task.goal.size();
+        for (const auto& goal : task.goal) output_stream << " " << goal.first << " " << goal.second;
+        output_stream << "\n";
+
+        output_stream << task.operators.size() << "\n";
+        for (const auto& op : task.operators) {
+            output_stream << op.name << "\n";
+            output_stream << op.prevail.size();
+            for (const auto& prevail : op.prevail) output_stream << " " << prevail.first << " " << prevail.second;
+            output_stream << "\n";
+            output_stream << op.pre_post.size();
+            for (const auto& pre_post : op.pre_post)
+                output_stream << " " << std::get<0>(pre_post) << " " << std::get<1>(pre_post) << " " << std::get<2>(pre_post);
+            output_stream << "\n";
+        }
+
+        output_stream << task.invariants.size() << "\n";
+        for (const auto& invariant : task.invariants) {
+            for (std::size_t i = 0; i < invariant.size(); ++i) output_stream << (i ? ";" : "") << invariant[i];
+            output_stream << "\n";
+        }
+        store("task.txt", output_stream.str());
+    }
+
+    bool DomainCache::load_bdds(const std::shared_ptr<CUDD::Cudd>& mgr, std::vector<CUDD::BDD>& bdds) const {
+        std::ifstream input_stream(entry_ / "dfa.bdd", std::ios::binary);
+        if (!input_stream) return false;
+        try {
+            bdds = BddSerializer::read(input_stream, mgr);
+        } catch (const std::runtime_error&) {
+            return false;
+        }
+        return true;
+    }
+
+    void DomainCache::store_bdds(const std::shared_ptr<CUDD::Cudd>& mgr, const std::vector<CUDD::BDD>& bdds) const {
+        std::ostringstream output_stream;
+        BddSerializer::write(output_stream, mgr, bdds);
+        store("dfa.bdd", output_stream.str());
+    }
+}
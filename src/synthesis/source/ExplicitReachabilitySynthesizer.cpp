@@ -0,0 +1,227 @@
+#include "ExplicitReachabilitySynthesizer.h"
+
+#include <cassert>
+#include <stdexcept>
+#include <utility>
+
+#include "Stopwatch.h"
+
+namespace Syft {
+
+ExplicitReachabilitySynthesizer::ExplicitReachabilitySynthesizer(
+    std::shared_ptr<VarMgr> var_mgr,
+    std::size_t automaton_id,
+    std::vector<int> initial_state,
+    const std::unordered_set<int>& pos_goal,
+    const std::unordered_set<int>& neg_goal,
+    const std::vector<ExplicitActionPartition>& partitions,
+    std::size_t fluent_count)
+    : var_mgr_(std::move(var_mgr))
+    , automaton_id_(automaton_id)
+    , initial_state_(std::move(initial_state))
+    , fluent_count_(fluent_count)
+    , winning_states_(var_mgr_->cudd_mgr()->bddZero())
+    , winning_moves_(var_mgr_->cudd_mgr()->bddZero())
+    , iterations_(0) {
+  pos_goal_ = pack(std::vector<std::size_t>(pos_goal.begin(), pos_goal.end()));
+  // Domain stores negative goal literals as negated fluent ids
+  std::vector<std::size_t> neg_goal_fluents;
+  for (int i : neg_goal) neg_goal_fluents.push_back(-i);
+  neg_goal_ = pack(neg_goal_fluents);
+  actions_.reserve(partitions.size());
+  for (const auto& partition : partitions) {
+    PackedAction action;
+    action.agent_bdd = partition.agent_bdd;
+    action.pos_precondition = pack(partition.pos_precondition);
+    action.neg_precondition = pack(partition.neg_precondition);
+    for (std::size_t k = 0; k < partition.add_lists.size(); ++k) {
+      action.add_masks.push_back(pack(partition.add_lists[k]));
+      action.delete_masks.push_back(pack(partition.delete_lists[k]));
+    }
+    actions_.push_back(std::move(action));
+  }
+}
+
+ExplicitReachabilitySynthesizer::PackedState ExplicitReachabilitySynthesizer::pack(
+    const std::vector<std::size_t>& fluents) const {
+  PackedState packed((fluent_count_ + 63) / 64, 0);
+  for (std::size_t i : fluents) {
+    assert(i < fluent_count_);
+    packed[i / 64] |= std::uint64_t(1) << (i % 64);
+  }
+  return packed;
+}
+
+ExplicitReachabilitySynthesizer::PackedState ExplicitReachabilitySynthesizer::pack_state(
+    const std::vector<int>& state_vector) const {
+  std::vector<std::size_t> fluents;
+  for (std::size_t i = 0; i < fluent_count_; ++i) {
+    if (state_vector[i] == 1) fluents.push_back(i);
+  }
+  return pack(fluents);
+}
+
+std::vector<int> ExplicitReachabilitySynthesizer::unpack_state(
+    const PackedState& state) const {
+  // Explored states are never error states, error variables are 0
+  std::vector<int> state_vector(fluent_count_ + 2, 0);
+  for (std::size_t i = 0; i < fluent_count_; ++i) {
+    state_vector[i] = (state[i / 64] >> (i % 64)) & 1;
+  }
+  return state_vector;
+}
+
+bool ExplicitReachabilitySynthesizer::is_goal(const PackedState& state) const {
+  for (std::size_t w = 0; w < state.size(); ++w) {
+    if ((state[w] & pos_goal_[w]) != pos_goal_[w] || (state[w] & neg_goal_[w]) != 0) return false;
+  }
+  return true;
+}
+
+SynthesisResult ExplicitReachabilitySynthesizer::run() {
+  SynthesisResult result;
+  std::size_t word_count = (fluent_count_ + 63) / 64;
+
+  // An action of a state together with the number of its distinct successors
+  // not yet known to be winning
+  struct Move {
+    std::size_t state;
+    std::size_t action;
+    std::size_t pending;
+  };
+
+  std::vector<PackedState> states;
+  std::unordered_map<PackedState, std::size_t, PackedStateHash> state_ids;
+  std::vector<bool> goal;
+  std::vector<std::vector<std::size_t>> predecessor_moves;
+  std::vector<Move> moves;
+
+  auto add_state = [&](const PackedState& state) {
+    auto state_it = state_ids.find(state);
+    if (state_it != state_ids.end()) return state_it->second;
+    std::size_t id = states.size();
+    state_ids.emplace(state, id);
+    states.push_back(state);
+    goal.push_back(is_goal(state));
+    predecessor_moves.emplace_back();
+    return id;
+  };
+
+  // Forward exploration. Goal states are not expanded. Actions that are
+  // not applicable lead to the agent error
+  add_state(pack_state(initial_state_));
+  for (std::size_t s = 0; s < states.size(); ++s) {
+    // the explicit search runs outside CUDD, so it polls the flag itself
+    if (var_mgr_->cancelled()) throw std::runtime_error("Synthesis cancelled");
+    if (goal[s]) continue;
+    for (std::size_t a = 0; a < actions_.size(); ++a) {
+      const PackedAction& action = actions_[a];
+      bool applicable = true;
+      for (std::size_t w = 0; w < word_count && applicable; ++w) {
+        applicable = (states[s][w] & action.pos_precondition[w]) == action.pos_precondition[w] &&
+          (states[s][w] & action.neg_precondition[w]) == 0;
+      }
+      if (!applicable) continue;
+
+      std::unordered_set<std::size_t> successors;
+      for (std::size_t k = 0; k < action.add_masks.size(); ++k) {
+        PackedState successor(word_count);
+        for (std::size_t w = 0; w < word_count; ++w) {
+          successor[w] = (states[s][w] & ~action.delete_masks[k][w]) | action.add_masks[k][w];
+        }
+        successors.insert(add_state(successor));
+      }
+
+      std::size_t move_id = moves.size();
+      moves.push_back({s, a, successors.size()});
+      for (std::size_t successor : successors) predecessor_moves[successor].push_back(move_id);
+    }
+  }
+
+  // Backward attractor, one layer of newly winning states at a time
+  std::vector<bool> winning(goal);
+  std::vector<int> strategy(states.size(), -1);
+  std::vector<std::size_t> layer;
+  for (std::size_t s = 0; s < states.size(); ++s) {
+    if (goal[s]) layer.push_back(s);
+  }
+
+  iterations_ = 0;
+  iteration_times_.clear();
+  while (!layer.empty() && !winning[0]) {
+    if (var_mgr_->cancelled()) throw std::runtime_error("Synthesis cancelled");
+    Stopwatch iteration_time;
+    iteration_time.start();
+    ++iterations_;
+
+    std::vector<std::size_t> next_layer;
+    for (std::size_t s : layer) {
+      for (std::size_t move_id : predecessor_moves[s]) {
+        Move& move = moves[move_id];
+        if (--move.pending == 0 && !winning[move.state]) {
+          winning[move.state] = true;
+          strategy[move.state] = move_id;
+          next_layer.push_back(move.state);
+        }
+      }
+    }
+    layer.swap(next_layer);
+    iteration_times_.push_back(iteration_time.stop().count() / 1000.0);
+  }
+
+  // Back to the symbolic representation of the game
+  std::vector<CUDD::BDD> output_variables;
+  std::unordered_map<int, CUDD::BDD> output_function;
+  for (const auto& label : var_mgr_->output_variable_labels()) {
+    CUDD::BDD output_variable = var_mgr_->name_to_variable(label);
+    output_variables.push_back(output_variable);
+    output_function[output_variable.NodeReadIndex()] = var_mgr_->cudd_mgr()->bddZero();
+  }
+
+  CUDD::BDD winning_states = var_mgr_->cudd_mgr()->bddZero();
+  CUDD::BDD winning_moves = var_mgr_->cudd_mgr()->bddZero();
+  for (std::size_t s = 0; s < states.size(); ++s) {
+    if (!winning[s]) continue;
+    CUDD::BDD state_bdd = var_mgr_->state_vector_to_bdd(automaton_id_,
+                                                        unpack_state(states[s]));
+    winning_states |= state_bdd;
+    if (strategy[s] < 0) {
+      winning_moves |= state_bdd;
+      continue;
+    }
+    CUDD::BDD agent_bdd = actions_[moves[strategy[s]].action].agent_bdd;
+    winning_moves |= state_bdd & agent_bdd;
+    for (const auto& output_variable : output_variables) {
+      if (!agent_bdd.Cofactor(output_variable).IsZero()) {
+        output_function[output_variable.NodeReadIndex()] |= state_bdd;
+      }
+    }
+  }
+
+  result.realizability = winning[0];
+  result.winning_states = winning_states;
+  result.transducer = std::make_unique<Transducer>(
+        var_mgr_, var_mgr_->make_eval_vector(automaton_id_, initial_state_),
+        output_function, std::vector<CUDD::BDD>(), Player::Agent, Player::Agent);
+  winning_states_ = winning_states;
+  winning_moves_ = winning_moves;
+  return result;
+}
+
+CUDD::BDD ExplicitReachabilitySynthesizer::get_winning_states() const {
+  return winning_states_;
+}
+
+CUDD::BDD ExplicitReachabilitySynthesizer::get_winning_moves() const {
+  return winning_moves_;
+}
+
+std::size_t ExplicitReachabilitySynthesizer::get_iterations() const {
+  return iterations_;
+}
+
+std::vector<double> ExplicitReachabilitySynthesizer::get_iteration_times() const {
+  return iteration_times_;
+}
+
+}
@@ -4,6 +4,9 @@
 
 #include"FONDSynthesizer.h"
 
+#include<fstream>
+#include<stdexcept>
+
 namespace Syft {
 
 
@@ -12,44 +15,111 @@ namespace Syft {
         std::shared_ptr<Syft::VarMgr> var_mgr,
         const std::string& domain_file,
         const std::string& problem_file,
-        bool interactive
+        bool interactive,
+        bool frontier,
+        SynthesisEngine engine,
+        std::size_t cluster_threshold,
+        bool fused,
+        bool forward_reachability,
+        bool python_grounding,
+        const std::string& cache_dir,
+        bool prune,
+        bool log_encoding,
+        VariableOrderHeuristic var_order,
+        const std::string& import_order_file,
+        const std::string& export_order_file,
+        const std::string& dfa_file
     ) : var_mgr_(var_mgr),
         domain_file_(domain_file),
         problem_file_(problem_file), 
-        interactive_(interactive) {}
+        interactive_(interactive),
+        frontier_(frontier),
+        engine_(engine),
+        cluster_threshold_(cluster_threshold),
+        fused_(fused),
+        forward_reachability_(forward_reachability),
+        python_grounding_(python_grounding),
+        cache_dir_(cache_dir),
+        prune_(prune),
+        log_encoding_(log_encoding),
+        var_order_(var_order),
+        import_order_file_(import_order_file),
+        export_order_file_(export_order_file),
+        dfa_file_(dfa_file),
+        fixpoint_iterations_(0),
+        log_(&std::cout) {}
 
     SynthesisResult FONDSynthesizer::run() {
+        if (!dfa_file_.empty()) return run_loaded();
         SynthesisResult result;
 
         // parse domain_file and problem_file to construct domain
         Syft::Stopwatch pddl_parsing;
         pddl_parsing.start();
 
-        std::cout << "[pddl2dfa] Parsing PDDL domain...";
-        Domain domain(var_mgr_, domain_file_, problem_file_);
+        *log_ << "[pddl2dfa] Parsing PDDL domain...";
+        Domain domain(var_mgr_, domain_file_, problem_file_, python_grounding_, cache_dir_, prune_, log_encoding_, var_order_, import_order_file_);
         double t_pddl_parsing = pddl_parsing.stop().count() / 1000.0;
-        std::cout << "Done [" << t_pddl_parsing << " s]" << std::endl;
+        *log_ << "Done [" << t_pddl_parsing << " s]" << std::endl;
+        domain.print_pruning(*log_);
 
         running_times_.push_back(t_pddl_parsing);
 
+        // small domains are solved explicitly, which
+        // requires one state variable per atom
+        SynthesisEngine engine = engine_;
+        if (engine == SynthesisEngine::Automatic) {
+            if (!log_encoding_ && domain.get_vars().size() <= explicit_max_fluents_ && domain.get_action_count() <= explicit_max_actions_)
+                engine = SynthesisEngine::Explicit;
+            else engine = SynthesisEngine::Monolithic;
+        }
+        if (engine == SynthesisEngine::Explicit) return run_explicit(domain);
+
         // transform domain into a symbolic DFA
         Syft::Stopwatch pddl2dfa;
         pddl2dfa.start();
+        const ReorderingPolicy& reordering_policy = var_mgr_->reordering_policy();
+        ReorderingCounter construction_reorderings(var_mgr_->cudd_mgr());
     
-        std::cout << "[pddl2dfa] Transforming PDDL to DFA..." << std::flush;;
-        SymbolicStateDfa domain_dfa = domain.to_symbolic();
+        *log_ << "[pddl2dfa] Transforming PDDL to DFA..." << std::flush;
+        // the partitioned engine computes preimages from the action partitions,
+        // the transition function is only needed by forward reachability
+        // and the interactive mode
+        bool transition_function = engine != SynthesisEngine::Partitioned || forward_reachability_ || interactive_;
+        SymbolicStateDfa domain_dfa = domain.to_symbolic(transition_function);
+        // the BDDs of the domain DFA are reused in every fixpoint iteration
+        if (reordering_policy.reorder_after_construction)
+            var_mgr_->cudd_mgr()->ReduceHeap(reordering_policy.converging_cudd_method());
         double t_pddl2dfa = pddl2dfa.stop().count() / 1000.0;
-        std::cout << "Done [" << t_pddl2dfa << " s]" << std::endl;
+        *log_ << "Done [" << t_pddl2dfa << " s]" << std::endl;
 
         running_times_.push_back(t_pddl2dfa);
+        reorderings_.push_back(construction_reorderings.reorderings());
+        reordering_times_.push_back(construction_reorderings.seconds());
 
         // domain.print_domain();
+        result = synthesize(domain_dfa, domain.get_state_var_count(), domain.get_invariants_bdd(), engine, &domain);
+
+        // the order reached by reordering during synthesis
+        if (!export_order_file_.empty()) domain.save_variable_order(domain_dfa.automaton_id(), export_order_file_);
+
+        if (result.realizability && interactive_) interactive(domain, domain_dfa, result);        
+        return result;
+    }
+
+    SynthesisResult FONDSynthesizer::synthesize(const SymbolicStateDfa& domain_dfa, std::size_t state_var_count,
+        const CUDD::BDD& invariant_bdd, SynthesisEngine engine, const Domain* domain) {
+        const ReorderingPolicy& reordering_policy = var_mgr_->reordering_policy();
         Syft::Stopwatch synthesis;
         synthesis.start();
+        if (reordering_policy.synthesis_reorderings == 0) var_mgr_->cudd_mgr()->AutodynDisable();
+        else if (reordering_policy.synthesis_reorderings > 0)
+            var_mgr_->cudd_mgr()->SetMaxReorderings(var_mgr_->cudd_mgr()->ReadReorderings() + reordering_policy.synthesis_reorderings);
+        ReorderingCounter synthesis_reorderings(var_mgr_->cudd_mgr());
 
-        std::cout << "[syft4fond] Synthesizing strategy..." << std::flush;
-        std::size_t agent_error_index = domain.get_vars().size();
-        std::size_t env_error_index = domain.get_vars().size() + 1;
+        *log_ << "[syft4fond] Synthesizing strategy..." << std::flush;
+        std::size_t agent_error_index = state_var_count;
+        std::size_t env_error_index = state_var_count + 1;
 
         CUDD::BDD agent_error_var = var_mgr_->get_state_variables(domain_dfa.automaton_id()).at(agent_error_index);
         CUDD::BDD env_error_var = var_mgr_->get_state_variables(domain_dfa.automaton_id()).at(env_error_index);
@@ -59,24 +129,139 @@ namespace Syft {
         // search for cooperative strategy to reach winning region
         // CUDD::BDD coop_final_states = (!agent_error_var) * (!env_error_var) * (domain_dfa.final_states());
 
-        // gets invariant of domain problem
-        CUDD::BDD invariant_bdd = domain.get_invariants_bdd();
+        // restricts the game to the states reachable from the initial state.
+        // The transition function applies the effects of an action even when
+        // its precondition fails, hence agent error states, which are never
+        // winning, are not explored
+        CUDD::BDD state_space = invariant_bdd;
+        if (forward_reachability_) state_space = domain_dfa.reachable_states(invariant_bdd * (!agent_error_var), cluster_threshold_);
 
         // synthesize strategy
-        ReachabilitySynthesizer adv_synthesizer(
-            domain_dfa,
-            Player::Agent,
-            Player::Agent,
-            adv_final_states * invariant_bdd,
-            invariant_bdd
+        std::unique_ptr<ReachabilitySynthesizer> adv_synthesizer;
+        if (engine == SynthesisEngine::Partitioned) {
+            adv_synthesizer = std::make_unique<PartitionedReachabilitySynthesizer>(
+                domain_dfa,
+                adv_final_states * state_space,
+                state_space,
+                domain->get_action_partitions(domain_dfa.automaton_id()),
+                agent_error_var,
+                env_error_var,
+                fused_
+            );
+        } else if (engine == SynthesisEngine::OnTheFly) {
+            adv_synthesizer = std::make_unique<OnTheFlySynthesizer>(
+                domain_dfa,
+                Player::Agent,
+                Player::Agent,
+                adv_final_states * state_space,
+                state_space,
+                agent_error_var,
+                cluster_threshold_
+            );
+        } else {
+            adv_synthesizer = std::make_unique<ReachabilitySynthesizer>(
+                domain_dfa,
+                Player::Agent,
+                Player::Agent,
+                adv_final_states * state_space,
+                state_space,
+                frontier_,
+                cluster_threshold_,
+                fused_
+            );
+        }
+        SynthesisResult result = adv_synthesizer->run();
+        fixpoint_iterations_ = adv_synthesizer->get_iterations();
+        iteration_times_ = adv_synthesizer->get_iteration_times();
+        double t_synthesis = synthesis.stop().count() / 1000.0;
+        *log_ << "Done [" << t_synthesis << " s]" << std::endl;
+
+        running_times_.push_back(t_synthesis);
+        reorderings_.push_back(synthesis_reorderings.reorderings());
+        reordering_times_.push_back(synthesis_reorderings.seconds());
+
+        return result;
+    }
+
+    SynthesisResult FONDSynthesizer::run_loaded() {
+        // the file holds neither the grounded actions nor the atom names
+        if (engine_ != SynthesisEngine::Monolithic && engine_ != SynthesisEngine::OnTheFly)
+            throw std::runtime_error("A saved domain DFA can only be solved by the monolithic and on-the-fly engines");
+
+        Syft::Stopwatch loading;
+        loading.start();
+        *log_ << "[syft4fond] Loading domain DFA...";
+        std::ifstream dfa_stream(dfa_file_, std::ios::binary);
+        if (!dfa_stream) throw std::runtime_error("Unable to read " + dfa_file_);
+        SavedDomainDfa saved = Domain::load_dfa(dfa_stream);
+
+        // the loaded variables live in a manager of their own, which
+        // takes over the settings of the given one
+        saved.var_mgr->set_reordering_policy(var_mgr_->reordering_policy());
+        saved.var_mgr->set_cancellation_flag(var_mgr_->cancellation_flag());
+        var_mgr_ = saved.var_mgr;
+        var_mgr_->enable_reordering();
+        if (var_mgr_->reordering_policy().reorder_after_construction)
+            var_mgr_->cudd_mgr()->ReduceHeap(var_mgr_->reordering_policy().converging_cudd_method());
+        double t_loading = loading.stop().count() / 1000.0;
+        *log_ << "Done [" << t_loading << " s]" << std::endl;
+
+        // nothing is parsed, loading takes the place of the DFA construction
+        running_times_.push_back(0);
+        running_times_.push_back(t_loading);
+        reorderings_.push_back(0);
+        reordering_times_.push_back(0);
+
+        SynthesisResult result = synthesize(saved.dfa, saved.state_var_count, saved.invariants, engine_, nullptr);
+        if (result.realizability && interactive_)
+            *log_ << "[syft4fond] Interactive debugging requires the grounded domain, which a saved domain DFA does not hold" << std::endl;
+        return result;
+    }
+
+    SynthesisResult FONDSynthesizer::run_explicit(Domain& domain) {
+        // only the variables are created, the explicit
+        // engine works on the grounded actions
+        Syft::Stopwatch pddl2dfa;
+        pddl2dfa.start();
+        ReorderingCounter construction_reorderings(var_mgr_->cudd_mgr());
+
+        *log_ << "[pddl2dfa] Creating DFA variables..." << std::flush;
+        std::size_t domain_dfa_id = domain.create_variables();
+        double t_pddl2dfa = pddl2dfa.stop().count() / 1000.0;
+        *log_ << "Done [" << t_pddl2dfa << " s]" << std::endl;
+
+        running_times_.push_back(t_pddl2dfa);
+        reorderings_.push_back(construction_reorderings.reorderings());
+        reordering_times_.push_back(construction_reorderings.seconds());
+
+        Syft::Stopwatch synthesis;
+        synthesis.start();
+        ReorderingCounter synthesis_reorderings(var_mgr_->cudd_mgr());
+
+        *log_ << "[syft4fond] Synthesizing strategy..." << std::flush;
+        ExplicitReachabilitySynthesizer synthesizer(
+            var_mgr_,
+            domain_dfa_id,
+            domain.get_dfa_initial_state(),
+            domain.get_pos_goal(),
+            domain.get_neg_goal(),
+            domain.get_explicit_action_partitions(),
+            domain.get_vars().size()
         );
-        result = adv_synthesizer.run();
+        SynthesisResult result = synthesizer.run();
+        fixpoint_iterations_ = synthesizer.get_iterations();
+        iteration_times_ = synthesizer.get_iteration_times();
         double t_synthesis = synthesis.stop().count() / 1000.0;
-        std::cout << "Done [" << t_synthesis << " s]" << std::endl;
+        *log_ << "Done [" << t_synthesis << " s]" << std::endl;
 
         running_times_.push_back(t_synthesis);
+        reorderings_.push_back(synthesis_reorderings.reorderings());
+        reordering_times_.push_back(synthesis_reorderings.seconds());
 
-        if (result.realizability && interactive_) interactive(domain, domain_dfa, result);        
+        if (!export_order_file_.empty()) domain.save_variable_order(domain_dfa_id, export_order_file_);
+
+        if (result.realizability && interactive_)
+            *log_ << "[syft4fond] Interactive debugging requires the domain DFA, which the explicit engine does not build" << std::endl;
         return result;
     }
 
@@ -89,11 +274,10 @@ namespace Syft {
         // auxiliary data structures
         std::map<int, std::string> id_to_action_name = domain.get_id_to_action_name();
         std::map<int, std::string> id_to_reaction_name = domain.get_id_to_reaction_name();
-        std::vector<std::string> domain_vars = domain.get_vars();
         std::vector<CUDD::BDD> transition_function = domain_dfa.transition_function();
         CUDD::BDD final_states = domain_dfa.final_states();
-        CUDD::BDD agent_error_var = var_mgr_->state_variable(domain_dfa.automaton_id(), domain_vars.size());
-        CUDD::BDD env_error_var = var_mgr_->state_variable(domain_dfa.automaton_id(), domain_vars.size()+1);
+        CUDD::BDD agent_error_var = var_mgr_->state_variable(domain_dfa.automaton_id(), domain.get_state_var_count());
+        CUDD::BDD env_error_var = var_mgr_->state_variable(domain_dfa.automaton_id(), domain.get_state_var_count()+1);
         std::unordered_map<int, std::string> id_to_var = var_mgr_->get_index_to_name();
         std::unordered_map<int, CUDD::BDD> output_function = result.transducer.get() -> get_output_function();
 
@@ -118,8 +302,7 @@ namespace Syft {
             std::cout << std::endl;
 
             std::string string_state = "{";
-            for (int i = 0; i < domain_vars.size(); ++i) 
-                if (state[i] == 1) string_state += domain_vars[i] + ", ";
+            for (const auto& atom : domain.get_true_atoms(state)) string_state += atom + ", ";
             string_state = string_state.substr(0, string_state.size() - 2) + "}";
             std::cout << "[syft4fond] State vars: " << string_state << std::endl;
 
@@ -138,7 +321,7 @@ namespace Syft {
             
             // get agent action
             std::vector<int> bin_agent_action;
-            std::size_t domain_dfa_vars = domain_vars.size() + 2;
+            std::size_t domain_dfa_vars = domain.get_state_var_count() + 2;
             for (int i = domain_dfa_vars; i < domain_dfa_vars + id_to_var.size(); ++i) {
                 // agent vars bin encoding
                 std::string var = id_to_var[i];
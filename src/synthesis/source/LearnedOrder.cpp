@@ -0,0 +1,122 @@
+/*
+* Definition of class LearnedOrder
+*/
+
+#include"LearnedOrder.h"
+
+#include<algorithm>
+#include<cctype>
+#include<fstream>
+#include<functional>
+#include<map>
+#include<stdexcept>
+#include<unordered_map>
+
+namespace Syft {
+
+    std::string LearnedOrder::pattern(const std::string& name) {
+        std::string key;
+        for (std::size_t i = 0; i < name.size(); ++i) {
+            if (!std::isdigit(static_cast<unsigned char>(name[i]))) key += name[i];
+            else if (i == 0 || !std::isdigit(static_cast<unsigned char>(name[i - 1]))) key += '#';
+        }
+        return key;
+    }
+
+    std::string LearnedOrder::predicate(const std::string& name) {
+        std::string key, token;
+        for (std::size_t i = 0; i <= name.size(); ++i) {
+            if (i < name.size() && name[i] != '_') {
+                token += name[i];
+                continue;
+            }
+            bool has_digit = std::any_of(token.begin(), token.end(), [](unsigned char c) { return std::isdigit(c); });
+            if (!has_digit && !token.empty()) key += (key.empty() ? "" : "_") + token;
+            token.clear();
+        }
+        return key;
+    }
+
+    std::vector<long> LearnedOrder::numbers(const std::string& name) {
+        std::vector<long> values;
+        for (std::size_t i = 0; i < name.size(); ) {
+            if (!std::isdigit(static_cast<unsigned char>(name[i]))) {
+                ++i;
+                continue;
+            }
+            std::size_t j = i;
+            while (j < name.size() && std::isdigit(static_cast<unsigned char>(name[j]))) ++j;
+            values.push_back(std::stol(name.substr(i, std::min<std::size_t>(j - i, 18))));
+            i = j;
+        }
+        return values;
+    }
+
+    LearnedOrder LearnedOrder::load(const std::string& file) {
+        std::ifstream input_stream(file);
+        if (!input_stream) throw std::runtime_error("Unable to read variable order " + file);
+        std::vector<std::string> names;
+        std::string name;
+        while (std::getline(input_stream, name))
+            if (!name.empty()) names.push_back(name);
+        return LearnedOrder(std::move(names));
+    }
+
+    void LearnedOrder::save(const std::string& file) const {
+        std::ofstream output_stream(file);
+        for (const auto& name : names_) output_stream << name << "\n";
+        if (!output_stream) throw std::runtime_error("Unable to write variable order " + file);
+    }
+
+    std::vector<int> LearnedOrder::order(const std::vector<std::string>& names, const std::vector<int>& fallback) const {
+        // relative position in [0, 1] of each learned name
+        auto learned_position = [&](std::size_t i) {
+            return names_.size() > 1 ? double(i) / (names_.size() - 1) : 0.0;
+        };
+
+        std::vector<double> position(names.size(), -1);
+        std::unordered_map<std::string, double> exact;
+        for (std::size_t i = 0; i < names_.size(); ++i) exact.emplace(names_[i], learned_position(i));
+        for (std::size_t v = 0; v < names.size(); ++v) {
+            auto it = exact.find(names[v]);
+            if (it != exact.end()) position[v] = it->second;
+        }
+
+        // variables of each key are sorted by the objects they mention and
+        // spread over the learned positions of the same key. Only those
+        // without a position yet are moved
+        auto match = [&](const std::function<std::string(const std::string&)>& key) {
+            std::map<std::string, std::vector<double>> learned;
+            for (std::size_t i = 0; i < names_.size(); ++i) learned[key(names_[i])].push_back(learned_position(i));
+            std::map<std::string, std::vector<int>> key_vars;
+            for (std::size_t v = 0; v < names.size(); ++v)
+                if (learned.count(key(names[v]))) key_vars[key(names[v])].push_back(v);
+            std::vector<double> matched(position);
+            for (auto& vars : key_vars) {
+                const std::vector<double>& positions = learned[vars.first];
+                std::stable_sort(vars.second.begin(), vars.second.end(), [&](int lhs, int rhs) {
+                    return numbers(names[lhs]) < numbers(names[rhs]);
+                });
+                for (std::size_t k = 0; k < vars.second.size(); ++k) {
+                    if (matched[vars.second[k]] >= 0) continue;
+                    std::size_t i = vars.second.size() > 1 ? k * (positions.size() - 1) / (vars.second.size() - 1) : (positions.size() - 1) / 2;
+                    position[vars.second[k]] = positions[i];
+                }
+            }
+        };
+        match(pattern);
+        match(predicate);
+
+        // remaining variables keep their relative position in fallback
+        std::vector<std::size_t> fallback_position(names.size());
+        for (std::size_t k = 0; k < fallback.size(); ++k) fallback_position[fallback[k]] = k;
+        for (std::size_t v = 0; v < names.size(); ++v)
+            if (position[v] < 0) position[v] = names.size() > 1 ? double(fallback_position[v]) / (names.size() - 1) : 0.0;
+
+        std::vector<int> order = fallback;
+        std::stable_sort(order.begin(), order.end(), [&](int lhs, int rhs) {
+            return position[lhs] < position[rhs];
+        });
+        return order;
+    }
+}
@@ -0,0 +1,77 @@
+#include "OnTheFlySynthesizer.h"
+
+#include "Stopwatch.h"
+
+namespace Syft {
+
+OnTheFlySynthesizer::OnTheFlySynthesizer(SymbolicStateDfa spec,
+                                         Player starting_player, Player protagonist_player,
+                                         CUDD::BDD goal_states,
+                                         CUDD::BDD state_space,
+                                         CUDD::BDD agent_error_var,
+                                         std::size_t cluster_threshold)
+    : ReachabilitySynthesizer(spec, starting_player, protagonist_player,
+                              goal_states, state_space, false,
+                              cluster_threshold)
+    , agent_error_var_(agent_error_var)
+{}
+
+SynthesisResult OnTheFlySynthesizer::run() {
+  SynthesisResult result;
+  CUDD::BDD initial_state = var_mgr_->state_vector_to_bdd(spec_.automaton_id(),
+                                                          spec_.initial_state());
+  CUDD::BDD explored_states = state_space_ & initial_state;
+  CUDD::BDD frontier = explored_states;
+  CUDD::BDD winning_states = explored_states & goal_states_;
+  CUDD::BDD winning_moves = winning_states;
+
+  iterations_ = 0;
+  iteration_times_.clear();
+  while (true) {
+    Stopwatch iteration_time;
+    iteration_time.start();
+    ++iterations_;
+
+    // Winning states in the explored part of the game are winning in the whole
+    // game, since they are independent of the unexplored states
+    while (true) {
+      CUDD::BDD candidates = explored_states & (!winning_states);
+      CUDD::BDD new_moves = preimage(winning_states, candidates);
+      CUDD::BDD new_states = project_into_states(new_moves);
+      winning_moves |= new_moves;
+      if (new_states.IsZero()) break;
+      winning_states |= new_states;
+    }
+
+    // Only states not yet known to be winning need to be expanded. When no new
+    // state is found, every non-winning explored state has all its successors
+    // explored, hence the explored winning states are all the winning states
+    bool realizable = includes_initial_state(winning_states);
+    if (!realizable) {
+      // The transition function applies the effects of an action even when
+      // its precondition fails, hence agent-error states have successors
+      // that are unreachable otherwise
+      frontier = state_space_ & (!explored_states) & (!agent_error_var_) &
+        image(frontier & (!winning_states));
+      explored_states |= frontier;
+      winning_states |= frontier & goal_states_;
+      winning_moves |= frontier & goal_states_;
+    }
+    iteration_times_.push_back(iteration_time.stop().count() / 1000.0);
+
+    if (realizable || frontier.IsZero()) {
+      result.realizability = realizable;
+      result.winning_states = winning_states;
+      std::unordered_map<int, CUDD::BDD> strategy = synthesize_strategy(
+            winning_moves);
+      result.transducer = std::make_unique<Transducer>(
+            var_mgr_, initial_vector_, strategy, spec_.transition_function(),
+            starting_player_, protagonist_player_);
+      winning_states_ = winning_states;
+      winning_moves_ = winning_moves;
+      return result;
+    }
+  }
+}
+
+}
@@ -0,0 +1,48 @@
+#include "PartitionedReachabilitySynthesizer.h"
+
+namespace Syft {
+
+PartitionedReachabilitySynthesizer::PartitionedReachabilitySynthesizer(
+    SymbolicStateDfa spec,
+    CUDD::BDD goal_states,
+    CUDD::BDD state_space,
+    std::vector<ActionPartition> partitions,
+    CUDD::BDD agent_error_var,
+    CUDD::BDD env_error_var,
+    bool fused)
+    : ReachabilitySynthesizer(spec, Player::Agent, Player::Agent,
+                              goal_states, state_space, false, 0, fused)
+    , partitions_(std::move(partitions))
+    , agent_error_var_(std::move(agent_error_var))
+    , env_error_var_(std::move(env_error_var))
+{}
+
+CUDD::BDD PartitionedReachabilitySynthesizer::preimage(
+    const CUDD::BDD& winning_states) const {
+  // Agent-error states never reach the goal, and non-agent-error states in the
+  // environment-error state are goal states. Hence, only moves from states
+  // without errors matter. From such states, a legal action-reaction pair
+  // leads to a state without errors, an illegal reaction leaves the fluents
+  // unchanged and leads to the environment-error state
+  CUDD::BDD no_error = (!agent_error_var_) * (!env_error_var_);
+  CUDD::BDD winning_no_error = winning_states.Cofactor(no_error);
+  CUDD::BDD winning_env_error =
+    winning_states.Cofactor((!agent_error_var_) * env_error_var_);
+
+  CUDD::BDD preimage_bdd = var_mgr_->cudd_mgr()->bddZero();
+  for (const auto& partition : partitions_) {
+    CUDD::BDD action_preimage = partition.precondition;
+    if (partition.illegal_reactions)
+      action_preimage = action_preimage * winning_env_error;
+    // all outcomes of the action must lead into a winning state
+    for (const auto& effect : partition.effects) {
+      if (action_preimage.IsZero()) break;
+      action_preimage = action_preimage * winning_no_error.Cofactor(effect);
+    }
+    preimage_bdd = preimage_bdd + (partition.agent_bdd * action_preimage);
+  }
+
+  return no_error * preimage_bdd;
+}
+
+}
@@ -0,0 +1,945 @@
+/*
+* Definition of class PddlGrounder
+*/
+
+#include"PddlGrounder.h"
+
+#include<algorithm>
+#include<cctype>
+#include<chrono>
+#include<deque>
+#include<fstream>
+#include<functional>
+#include<future>
+#include<stdexcept>
+
+namespace Syft {
+
+    // bounds of the invariant synthesis, as in invariant_finder.py
+    static const std::size_t max_invariant_candidates = 100000;
+    static const std::chrono::seconds invariant_time_limit(10);
+
+    static bool is_variable(const std::string& arg) {
+        return !arg.empty() && arg[0] == '?';
+    }
+
+    // maps each object and ?-variable in equalities to the representative of
+    // its equivalence class. Returns false if two distinct objects are equal
+    static bool get_mapping(
+        const std::vector<std::pair<std::string, std::string>>& equalities,
+        std::map<std::string, std::string>& mapping
+    ) {
+        std::map<std::string, std::string> parent;
+        auto find = [&](std::string x) {
+            while (parent[x] != x) x = parent[x];
+            return x;
+        };
+        for (const auto& equality : equalities) {
+            parent.emplace(equality.first, equality.first);
+            parent.emplace(equality.second, equality.second);
+            std::string first = find(equality.first), second = find(equality.second);
+            if (first != second) parent[first] = second;
+        }
+
+        std::map<std::string, std::vector<std::string>> classes;
+        for (const auto& entry : parent) classes[find(entry.first)].push_back(entry.first);
+
+        // objects are preferred to variables, and smaller variables to larger ones
+        for (const auto& eq_class : classes) {
+            std::string representative;
+            for (const auto& item : eq_class.second) {
+                if (is_variable(item)) continue;
+                if (!representative.empty() && representative != item) return false;
+                representative = item;
+            }
+            if (representative.empty()) representative = eq_class.second.front();
+            for (const auto& item : eq_class.second) mapping[item] = representative;
+        }
+        return true;
+    }
+
+    void PddlGrounder::ConstraintSystem::combine(const ConstraintSystem& other) {
+        assignments.insert(assignments.end(), other.assignments.begin(), other.assignments.end());
+        negative_clauses.insert(negative_clauses.end(), other.negative_clauses.begin(), other.negative_clauses.end());
+    }
+
+    bool PddlGrounder::ConstraintSystem::is_solvable() const {
+        for (const auto& disjunction : assignments) if (disjunction.empty()) return false;
+
+        // tries every combination of one assignment per disjunction
+        std::vector<std::size_t> choice(assignments.size(), 0);
+        while (true) {
+            Equalities combined;
+            for (std::size_t i = 0; i < assignments.size(); ++i)
+                combined.insert(combined.end(), assignments[i][choice[i]].begin(), assignments[i][choice[i]].end());
+
+            std::map<std::string, std::string> mapping;
+            if (get_mapping(combined, mapping)) {
+                auto mapped = [&](const std::string& x) {
+                    auto it = mapping.find(x);
+                    return it == mapping.end() ? x : it->second;
+                };
+                bool satisfiable = true;
+                for (const auto& clause : negative_clauses) {
+                    bool clause_satisfiable = false;
+                    for (const auto& inequality : clause)
+                        if (mapped(inequality.first) != mapped(inequality.second)) clause_satisfiable = true;
+                    if (!clause_satisfiable) {
+                        satisfiable = false;
+                        break;
+                    }
+                }
+                if (satisfiable) return true;
+            }
+
+            std::size_t i = 0;
+            while (i < choice.size() && ++choice[i] == assignments[i].size()) choice[i++] = 0;
+            if (i == choice.size()) return false;
+        }
+    }
+
+    PddlGrounder::PddlGrounder(const std::string& domain_file, const std::string& problem_file,
+        const std::atomic<bool>* cancelled) : cancelled_(cancelled) {
+        parse_domain(domain_file);
+        parse_problem(problem_file);
+    }
+
+    bool PddlGrounder::cancelled() const {
+        return cancelled_ != nullptr && cancelled_->load();
+    }
+
+    void PddlGrounder::check_cancelled() const {
+        if (cancelled()) throw std::runtime_error("Grounding cancelled");
+    }
+
+    std::vector<PddlGrounder::SExpression> PddlGrounder::read_file(const std::string& pddl_file) {
+        std::ifstream pddl_stream(pddl_file);
+        if (!pddl_stream) throw std::runtime_error("Cannot open PDDL file " + pddl_file);
+
+        // comments are stripped and tokens lowercased, as in pddl/parser.py
+        std::vector<std::string> tokens;
+        std::string line;
+        while (std::getline(pddl_stream, line)) {
+            line = line.substr(0, line.find(';'));
+            std::string token;
+            for (char c : line) {
+                if (c == '(' || c == ')' || std::isspace(static_cast<unsigned char>(c))) {
+                    if (!token.empty()) tokens.push_back(token);
+                    token.clear();
+                    if (!std::isspace(static_cast<unsigned char>(c))) tokens.push_back(std::string(1, c));
+                } else {
+                    token += std::tolower(static_cast<unsigned char>(c));
+                }
+            }
+            if (!token.empty()) tokens.push_back(token);
+        }
+
+        std::vector<std::vector<SExpression>> stack(1);
+        for (const auto& token : tokens) {
+            if (token == "(") {
+                stack.emplace_back();
+            } else if (token == ")") {
+                if (stack.size() == 1) throw std::runtime_error("Unbalanced parentheses in " + pddl_file);
+                SExpression list {"", std::move(stack.back()), true};
+                stack.pop_back();
+                stack.back().push_back(std::move(list));
+            } else {
+                stack.back().push_back(SExpression {token, {}, false});
+            }
+        }
+        if (stack.size() != 1) throw std::runtime_error("Unbalanced parentheses in " + pddl_file);
+        return stack.front();
+    }
+
+    std::vector<std::pair<std::string, std::string>> PddlGrounder::parse_typed_list(
+        const std::vector<SExpression>& list,
+        std::size_t begin
+    ) {
+        std::vector<std::pair<std::string, std::string>> typed_list;
+        std::size_t untyped = 0;
+        for (std::size_t i = begin; i < list.size(); ++i) {
+            if (list[i].is_list) throw std::runtime_error("Unsupported PDDL typed list");
+            if (list[i].token == "-") {
+                if (i + 1 == list.size() || list[i+1].is_list)
+                    throw std::runtime_error("Unsupported PDDL type in typed list");
+                for (std::size_t j = typed_list.size() - untyped; j < typed_list.size(); ++j)
+                    typed_list[j].second = list[i+1].token;
+                untyped = 0;
+                ++i;
+            } else {
+                typed_list.push_back(std::make_pair(list[i].token, std::string("object")));
+                ++untyped;
+            }
+        }
+        return typed_list;
+    }
+
+    PddlGrounder::Literal PddlGrounder::parse_literal(const SExpression& expression) {
+        if (!expression.is_list || expression.children.empty() || expression.children[0].is_list)
+            throw std::runtime_error("Unsupported PDDL literal");
+        const SExpression& head = expression.children[0];
+        if (head.token == "not") {
+            if (expression.children.size() != 2) throw std::runtime_error("Unsupported PDDL negation");
+            Literal literal = parse_literal(expression.children[1]);
+            if (literal.negated) throw std::runtime_error("Unsupported PDDL negation");
+            literal.negated = true;
+            return literal;
+        }
+        if (head.token == "and" || head.token == "or" || head.token == "imply" || head.token == "exists" ||
+            head.token == "forall" || head.token == "when" || head.token == "oneof" || head.token == "increase")
+            throw std::runtime_error("Unsupported PDDL construct " + head.token);
+
+        Literal literal {head.token, {}, false};
+        for (std::size_t i = 1; i < expression.children.size(); ++i) {
+            if (expression.children[i].is_list) throw std::runtime_error("Unsupported PDDL function term");
+            literal.args.push_back(expression.children[i].token);
+        }
+        return literal;
+    }
+
+    void PddlGrounder::parse_condition(const SExpression& expression, std::vector<Literal>& literals) {
+        if (expression.is_list && !expression.children.empty() &&
+            !expression.children[0].is_list && expression.children[0].token == "and") {
+            for (std::size_t i = 1; i < expression.children.size(); ++i)
+                parse_condition(expression.children[i], literals);
+        } else if (expression.is_list && expression.children.empty()) {
+            return;
+        } else {
+            literals.push_back(parse_literal(expression));
+        }
+    }
+
+    std::vector<std::vector<PddlGrounder::Literal>> PddlGrounder::parse_effect(const SExpression& expression) {
+        if (!expression.is_list) throw std::runtime_error("Unsupported PDDL effect");
+        std::string tag = expression.children.empty() || expression.children[0].is_list ?
+            "" : expression.children[0].token;
+
+        if (tag == "and") {
+            // one outcome per combination of the outcomes of the conjuncts,
+            // the first conjunct varying fastest as in pddl/effects.py
+            std::vector<std::vector<Literal>> outcomes(1);
+            for (std::size_t i = expression.children.size() - 1; i > 0; --i) {
+                std::vector<std::vector<Literal>> conjunct_outcomes = parse_effect(expression.children[i]);
+                std::vector<std::vector<Literal>> new_outcomes;
+                for (const auto& outcome : outcomes) {
+                    for (const auto& conjunct_outcome : conjunct_outcomes) {
+                        std::vector<Literal> new_outcome(conjunct_outcome);
+                        new_outcome.insert(new_outcome.end(), outcome.begin(), outcome.end());
+                        new_outcomes.push_back(std::move(new_outcome));
+                    }
+                }
+                outcomes = std::move(new_outcomes);
+            }
+            return outcomes;
+        } else if (tag == "oneof") {
+            std::vector<std::vector<Literal>> outcomes;
+            for (std::size_t i = 1; i < expression.children.size(); ++i) {
+                std::vector<std::vector<Literal>> option_outcomes = parse_effect(expression.children[i]);
+                outcomes.insert(outcomes.end(), option_outcomes.begin(), option_outcomes.end());
+            }
+            return outcomes;
+        } else if (expression.children.empty()) {
+            return std::vector<std::vector<Literal>>(1);
+        }
+        return std::vector<std::vector<Literal>>(1, std::vector<Literal>(1, parse_literal(expression)));
+    }
+
+    void PddlGrounder::parse_domain(const std::string& domain_file) {
+        std::vector<SExpression> expressions = read_file(domain_file);
+        if (expressions.size() != 1 || !expressions[0].is_list || expressions[0].children.empty() ||
+            expressions[0].children[0].token != "define")
+            throw std::runtime_error("Unsupported PDDL domain file " + domain_file);
+
+        supertype_["object"] = "";
+        for (std::size_t i = 2; i < expressions[0].children.size(); ++i) {
+            const SExpression& section = expressions[0].children[i];
+            if (!section.is_list || section.children.empty()) throw std::runtime_error("Unsupported PDDL domain section");
+            const std::string& tag = section.children[0].token;
+            if (tag == ":requirements") {
+                continue;
+            } else if (tag == ":types") {
+                for (const auto& type : parse_typed_list(section.children, 1))
+                    if (type.first != "object") supertype_[type.first] = type.second;
+            } else if (tag == ":constants") {
+                for (const auto& constant : parse_typed_list(section.children, 1)) objects_.push_back(constant);
+            } else if (tag == ":predicates") {
+                for (std::size_t j = 1; j < section.children.size(); ++j) {
+                    const SExpression& predicate = section.children[j];
+                    if (!predicate.is_list || predicate.children.empty()) throw std::runtime_error("Unsupported PDDL predicate");
+                    std::vector<std::string> types;
+                    for (const auto& argument : parse_typed_list(predicate.children, 1)) types.push_back(argument.second);
+                    predicates_.push_back(std::make_pair(predicate.children[0].token, types));
+                }
+            } else if (tag == ":action") {
+                parse_action(section);
+            } else {
+                throw std::runtime_error("Unsupported PDDL domain section " + tag);
+            }
+        }
+    }
+
+    void PddlGrounder::parse_action(const SExpression& action) {
+        if (action.children.size() < 2 || action.children[1].is_list) throw std::runtime_error("Unsupported PDDL action");
+        std::string name = action.children[1].token;
+        std::vector<std::pair<std::string, std::string>> parameters;
+        std::vector<Literal> precondition;
+        std::vector<std::vector<Literal>> outcomes(1);
+
+        for (std::size_t i = 2; i + 1 < action.children.size(); i += 2) {
+            const std::string& tag = action.children[i].token;
+            const SExpression& value = action.children[i+1];
+            if (tag == ":parameters") parameters = parse_typed_list(value.children, 0);
+            else if (tag == ":precondition") parse_condition(value, precondition);
+            else if (tag == ":effect") outcomes = parse_effect(value);
+            else throw std::runtime_error("Unsupported PDDL action field " + tag);
+        }
+
+        auto check_arguments = [&](const std::vector<Literal>& literals) {
+            for (const auto& literal : literals)
+                for (const auto& arg : literal.args)
+                    if (is_variable(arg) && std::find_if(parameters.begin(), parameters.end(),
+                        [&](const std::pair<std::string, std::string>& p) {return p.first == arg;}) == parameters.end())
+                        throw std::runtime_error("Unsupported PDDL variable " + arg + " in action " + name);
+        };
+        check_arguments(precondition);
+        for (const auto& outcome : outcomes) check_arguments(outcome);
+
+        // each outcome is a deterministic action, as in pddl/actions.py
+        for (std::size_t k = 0; k < outcomes.size(); ++k) {
+            Schema schema;
+            schema.name = outcomes.size() == 1 ? name : name + "_DETDUP_" + std::to_string(k);
+            schema.parameters = parameters;
+            schema.precondition = precondition;
+            // contradictory effects follow add-after-delete semantics
+            for (const auto& effect : outcomes[k]) {
+                Literal contradiction {effect.predicate, effect.args, !effect.negated};
+                auto it = std::find(schema.effects.begin(), schema.effects.end(), contradiction);
+                if (it == schema.effects.end()) {
+                    schema.effects.push_back(effect);
+                } else if (contradiction.negated) {
+                    schema.effects.erase(it);
+                    schema.effects.push_back(effect);
+                }
+            }
+            schemas_.push_back(schema);
+        }
+    }
+
+    void PddlGrounder::parse_problem(const std::string& problem_file) {
+        std::vector<SExpression> expressions = read_file(problem_file);
+        if (expressions.size() != 1 || !expressions[0].is_list || expressions[0].children.empty() ||
+            expressions[0].children[0].token != "define")
+            throw std::runtime_error("Unsupported PDDL problem file " + problem_file);
+
+        for (std::size_t i = 2; i < expressions[0].children.size(); ++i) {
+            const SExpression& section = expressions[0].children[i];
+            if (!section.is_list || section.children.empty()) throw std::runtime_error("Unsupported PDDL problem section");
+            const std::string& tag = section.children[0].token;
+            if (tag == ":domain" || tag == ":requirements") {
+                continue;
+            } else if (tag == ":objects") {
+                for (const auto& object : parse_typed_list(section.children, 1)) objects_.push_back(object);
+            } else if (tag == ":init") {
+                for (std::size_t j = 1; j < section.children.size(); ++j) {
+                    Literal fact = parse_literal(section.children[j]);
+                    if (fact.negated || fact.predicate == "=") throw std::runtime_error("Unsupported PDDL initial state");
+                    init_.push_back(Atom {fact.predicate, fact.args});
+                }
+            } else if (tag == ":goal") {
+                if (section.children.size() != 2) throw std::runtime_error("Unsupported PDDL goal");
+                parse_condition(section.children[1], goal_);
+            } else {
+                throw std::runtime_error("Unsupported PDDL problem section " + tag);
+            }
+        }
+
+        for (const auto& object : objects_) {
+            if (supertype_.find(object.second) == supertype_.end())
+                throw std::runtime_error("Undefined PDDL type " + object.second);
+            init_.push_back(Atom {"=", {object.first, object.first}});
+        }
+    }
+
+    std::string PddlGrounder::atom_to_string(const Atom& atom) {
+        std::string atom_string = atom.predicate + "(";
+        for (std::size_t i = 0; i < atom.args.size(); ++i)
+            atom_string += (i > 0 ? ", " : "") + atom.args[i];
+        return atom_string + ")";
+    }
+
+    GroundTask PddlGrounder::unsolvable_task() {
+        GroundTask task;
+        task.atoms = {"dummy(val1)", "dummy(val2)"};
+        task.init = {0};
+        task.goal = {std::make_pair(0, 1)};
+        return task;
+    }
+
+    std::vector<std::vector<std::string>> PddlGrounder::get_bindings(
+        const Schema& schema,
+        const std::unordered_map<std::string, std::vector<std::vector<std::string>>>& model,
+        const std::unordered_map<std::string, std::set<std::string>>& objects_by_type
+    ) const {
+        std::unordered_map<std::string, std::size_t> parameter_index;
+        for (std::size_t i = 0; i < schema.parameters.size(); ++i) parameter_index[schema.parameters[i].first] = i;
+
+        auto objects_of = [&](std::size_t i) -> const std::set<std::string>& {
+            static const std::set<std::string> no_objects;
+            auto it = objects_by_type.find(schema.parameters[i].second);
+            return it == objects_by_type.end() ? no_objects : it->second;
+        };
+
+        // negative literals are relaxed. Literals with more bound parameters
+        // are joined first
+        std::vector<const Literal*> literals;
+        for (const auto& literal : schema.precondition) if (!literal.negated) literals.push_back(&literal);
+        std::vector<bool> bound(schema.parameters.size(), false);
+        for (std::size_t i = 0; i < literals.size(); ++i) {
+            auto score = [&](const Literal* literal) {
+                int bound_args = 0;
+                for (const auto& arg : literal->args)
+                    if (!is_variable(arg) || bound[parameter_index.at(arg)]) ++bound_args;
+                return bound_args - static_cast<int>(literal->args.size());
+            };
+            auto best = std::max_element(literals.begin() + i, literals.end(),
+                [&](const Literal* lhs, const Literal* rhs) {return score(lhs) < score(rhs);});
+            std::iter_swap(literals.begin() + i, best);
+            for (const auto& arg : literals[i]->args)
+                if (is_variable(arg)) bound[parameter_index.at(arg)] = true;
+        }
+
+        std::set<std::vector<std::string>> bindings;
+        std::vector<std::string> binding(schema.parameters.size());
+
+        std::function<void(std::size_t)> bind_free = [&](std::size_t i) {
+            if (i == binding.size()) {
+                bindings.insert(binding);
+                return;
+            }
+            if (!binding[i].empty()) {
+                bind_free(i + 1);
+                return;
+            }
+            for (const auto& object : objects_of(i)) {
+                binding[i] = object;
+                bind_free(i + 1);
+            }
+            binding[i].clear();
+        };
+
+        std::function<void(std::size_t)> join = [&](std::size_t l) {
+            if (l == literals.size()) {
+                bind_free(0);
+                return;
+            }
+            auto atoms = model.find(literals[l]->predicate);
+            if (atoms == model.end()) return;
+            const std::vector<std::string>& args = literals[l]->args;
+            for (const auto& atom_args : atoms->second) {
+                if (atom_args.size() != args.size()) continue;
+                std::vector<std::size_t> newly_bound;
+                bool match = true;
+                for (std::size_t j = 0; j < args.size() && match; ++j) {
+                    if (!is_variable(args[j])) {
+                        match = args[j] == atom_args[j];
+                    } else {
+                        std::size_t i = parameter_index.at(args[j]);
+                        if (binding[i].empty()) {
+                            match = objects_of(i).count(atom_args[j]) > 0;
+                            if (match) {
+                                binding[i] = atom_args[j];
+                                newly_bound.push_back(i);
+                            }
+                        } else {
+                            match = binding[i] == atom_args[j];
+                        }
+                    }
+                }
+                if (match) join(l + 1);
+                for (std::size_t i : newly_bound) binding[i].clear();
+            }
+        };
+
+        join(0);
+        return std::vector<std::vector<std::string>>(bindings.begin(), bindings.end());
+    }
+
+    GroundTask PddlGrounder::ground() const {
+        // invariant synthesis depends on the lifted task only, hence it runs
+        // concurrently with grounding
+        std::future<std::vector<std::vector<Atom>>> invariant_groups =
+            std::async(std::launch::async, &PddlGrounder::get_invariant_groups, this);
+
+        std::unordered_map<std::string, std::set<std::string>> objects_by_type;
+        for (const auto& object : objects_) {
+            for (std::string type = object.second; !type.empty(); type = supertype_.at(type)) {
+                objects_by_type[type].insert(object.first);
+                if (supertype_.find(type) == supertype_.end()) break;
+            }
+        }
+
+        auto substitute = [](const Schema& schema, const std::vector<std::string>& binding, const Literal& literal) {
+            Atom atom {literal.predicate, literal.args};
+            for (auto& arg : atom.args) {
+                if (!is_variable(arg)) continue;
+                for (std::size_t i = 0; i < schema.parameters.size(); ++i)
+                    if (schema.parameters[i].first == arg) arg = binding[i];
+            }
+            return atom;
+        };
+
+        // relaxed reachability, as the Datalog exploration in instantiate.py
+        std::set<Atom> init_facts(init_.begin(), init_.end());
+        std::set<Atom> model(init_facts);
+        std::unordered_map<std::string, std::vector<std::vector<std::string>>> model_index;
+        for (const auto& atom : model) model_index[atom.predicate].push_back(atom.args);
+
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            for (const auto& schema : schemas_) {
+                check_cancelled();
+                std::vector<Atom> new_atoms;
+                for (const auto& binding : get_bindings(schema, model_index, objects_by_type)) {
+                    for (const auto& effect : schema.effects) {
+                        if (effect.negated) continue;
+                        Atom atom = substitute(schema, binding, effect);
+                        if (model.insert(atom).second) new_atoms.push_back(atom);
+                    }
+                }
+                for (const auto& atom : new_atoms) model_index[atom.predicate].push_back(atom.args);
+                changed = changed || !new_atoms.empty();
+            }
+        }
+
+        for (const auto& literal : goal_)
+            if (!literal.negated && model.find(Atom {literal.predicate, literal.args}) == model.end())
+                return unsolvable_task();
+
+        // fluents are the reachable atoms of predicates occurring in effects,
+        // one binary variable each, sorted
+        std::set<std::string> fluent_predicates;
+        for (const auto& schema : schemas_)
+            for (const auto& effect : schema.effects) fluent_predicates.insert(effect.predicate);
+
+        GroundTask task;
+        std::map<Atom, int> fluent_to_var;
+        std::vector<Atom> fluents;
+        for (const auto& atom : model) {
+            if (fluent_predicates.find(atom.predicate) == fluent_predicates.end()) continue;
+            fluent_to_var[atom] = fluents.size();
+            fluents.push_back(atom);
+        }
+        for (const auto& atom : fluents) task.init.push_back(init_facts.count(atom) ? 0 : 1);
+
+        // conditions on variables, or false if contradictory. Static literals
+        // are evaluated against the initial state, if check_static holds
+        auto translate_conditions = [&](const Schema& schema, const std::vector<std::string>& binding,
+                                        const std::vector<Literal>& literals, bool check_static,
+                                        std::map<int, int>& condition) {
+            for (bool negated : {false, true}) {
+                for (const auto& literal : literals) {
+                    if (literal.negated != negated) continue;
+                    Atom atom = substitute(schema, binding, literal);
+                    auto fluent = fluent_to_var.find(atom);
+                    if (fluent == fluent_to_var.end()) {
+                        if (check_static && negated == (init_facts.count(atom) > 0)) return false;
+                        continue;
+                    }
+                    auto previous = condition.find(fluent->second);
+                    if (previous != condition.end() && previous->second != negated) return false;
+                    condition[fluent->second] = negated;
+                }
+            }
+            return true;
+        };
+
+        Schema goal_schema;
+        std::map<int, int> goal_condition;
+        if (!translate_conditions(goal_schema, {}, goal_, false, goal_condition)) return unsolvable_task();
+        task.goal.assign(goal_condition.begin(), goal_condition.end());
+
+        for (const auto& schema : schemas_) {
+            check_cancelled();
+            for (const auto& binding : get_bindings(schema, model_index, objects_by_type)) {
+                std::map<int, int> condition;
+                if (!translate_conditions(schema, binding, schema.precondition, true, condition)) continue;
+
+                std::set<int> add_vars, delete_vars;
+                for (const auto& effect : schema.effects) {
+                    auto fluent = fluent_to_var.find(substitute(schema, binding, effect));
+                    if (fluent == fluent_to_var.end()) continue;
+                    (effect.negated ? delete_vars : add_vars).insert(fluent->second);
+                }
+
+                // the prevail keeps all preconditions, effects not changing
+                // the value of their variable are skipped
+                GroundOperator op;
+                op.name = schema.name + " ";
+                for (std::size_t i = 0; i < binding.size(); ++i) op.name += (i > 0 ? " " : "") + binding[i];
+                op.prevail.assign(condition.begin(), condition.end());
+                for (int var : add_vars) {
+                    auto pre = condition.find(var);
+                    if (pre == condition.end()) op.pre_post.push_back(std::make_tuple(var, -1, 0));
+                    else if (pre->second != 0) op.pre_post.push_back(std::make_tuple(var, pre->second, 0));
+                }
+                for (int var : delete_vars) {
+                    if (add_vars.count(var)) continue;
+                    auto pre = condition.find(var);
+                    if (pre == condition.end()) op.pre_post.push_back(std::make_tuple(var, -1, 1));
+                    else if (pre->second != 1) op.pre_post.push_back(std::make_tuple(var, pre->second, 1));
+                }
+                task.operators.push_back(op);
+            }
+        }
+
+        // removes variables whose other value is unreachable from the initial
+        // one, as simplify.filter_unreachable_propositions
+        std::vector<bool> flips(fluents.size(), false);
+        for (const auto& op : task.operators) {
+            for (const auto& pre_post : op.pre_post) {
+                int var = std::get<0>(pre_post), pre = std::get<1>(pre_post), post = std::get<2>(pre_post);
+                if ((pre == -1 ? 1 - post : pre) == task.init[var] && post != task.init[var]) flips[var] = true;
+            }
+        }
+        std::vector<int> new_var(fluents.size(), -1);
+        GroundTask simplified;
+        for (std::size_t var = 0; var < fluents.size(); ++var) {
+            if (!flips[var]) continue;
+            new_var[var] = simplified.atoms.size();
+            simplified.atoms.push_back(atom_to_string(fluents[var]));
+            simplified.init.push_back(task.init[var]);
+        }
+
+        // constant values are always true, the others always false
+        auto translate_pairs = [&](const std::vector<std::pair<int, int>>& pairs, std::vector<std::pair<int, int>>& new_pairs) {
+            for (const auto& pair : pairs) {
+                if (new_var[pair.first] != -1) new_pairs.push_back(std::make_pair(new_var[pair.first], pair.second));
+                else if (pair.second != task.init[pair.first]) return false;
+            }
+            return true;
+        };
+
+        if (!translate_pairs(task.goal, simplified.goal)) return unsolvable_task();
+        for (const auto& op : task.operators) {
+            GroundOperator new_op;
+            new_op.name = op.name;
+            bool possible = translate_pairs(op.prevail, new_op.prevail);
+            for (const auto& pre_post : op.pre_post) {
+                int var = std::get<0>(pre_post), pre = std::get<1>(pre_post), post = std::get<2>(pre_post);
+                if (new_var[var] != -1) new_op.pre_post.push_back(std::make_tuple(new_var[var], pre, post));
+                else if (pre != -1 && pre != task.init[var]) possible = false;
+            }
+            if (possible) simplified.operators.push_back(new_op);
+        }
+
+        // grounds the mutex groups over the objects of the declared argument
+        // types of their predicates, as invariant_grounder.py
+        std::map<std::string, std::vector<std::string>> objects_by_declared_type;
+        for (const auto& object : objects_) objects_by_declared_type[object.second].push_back(object.first);
+        std::map<std::string, std::vector<std::string>> predicate_types(predicates_.begin(), predicates_.end());
+
+        for (const auto& group : invariant_groups.get()) {
+            std::vector<std::string> invariant;
+            for (const auto& part : group) {
+                std::vector<Atom> atoms(1, Atom {part.predicate, {}});
+                const std::vector<std::string>& types = predicate_types.at(part.predicate);
+                for (std::size_t i = 0; i < part.args.size(); ++i) {
+                    std::vector<Atom> new_atoms;
+                    std::vector<std::string> args = is_variable(part.args[i]) ?
+                        objects_by_declared_type[types.at(i)] : std::vector<std::string>(1, part.args[i]);
+                    for (const auto& atom : atoms) {
+                        for (const auto& arg : args) {
+                            new_atoms.push_back(atom);
+                            new_atoms.back().args.push_back(arg);
+                        }
+                    }
+                    atoms = std::move(new_atoms);
+                }
+                for (const auto& atom : atoms) invariant.push_back(atom_to_string(atom));
+            }
+            if (invariant.size() > 1) simplified.invariants.push_back(invariant);
+        }
+
+        return simplified;
+    }
+
+    std::vector<std::vector<PddlGrounder::Atom>> PddlGrounder::get_invariant_groups() const {
+        std::set<std::string> fluent_predicates;
+        for (const auto& schema : schemas_)
+            for (const auto& effect : schema.effects) fluent_predicates.insert(effect.predicate);
+
+        auto key = [](const Invariant& invariant) {
+            std::vector<std::pair<std::string, std::vector<int>>> invariant_key;
+            for (const auto& part : invariant) invariant_key.push_back(std::make_pair(part.predicate, part.order));
+            return invariant_key;
+        };
+
+        // initial candidates, one per fluent predicate and omitted argument
+        std::deque<Invariant> candidates;
+        std::set<std::vector<std::pair<std::string, std::vector<int>>>> seen_candidates;
+        for (const auto& predicate : predicates_) {
+            if (fluent_predicates.find(predicate.first) == fluent_predicates.end()) continue;
+            int arity = predicate.second.size();
+            for (int omitted = -1; omitted < arity; ++omitted) {
+                InvariantPart part {predicate.first, {}, omitted};
+                for (int i = 0; i < arity; ++i) if (i != omitted) part.order.push_back(i);
+                Invariant candidate(1, part);
+                if (seen_candidates.insert(key(candidate)).second) candidates.push_back(candidate);
+            }
+        }
+
+        std::vector<Invariant> invariants;
+        auto start = std::chrono::steady_clock::now();
+        while (!candidates.empty()) {
+            // a cancelled grounding throws, but waits for this thread first
+            if (cancelled() || std::chrono::steady_clock::now() - start > invariant_time_limit) break;
+            Invariant candidate = candidates.front();
+            candidates.pop_front();
+            std::vector<Invariant> refinements;
+            if (balanced(candidate, refinements)) invariants.push_back(candidate);
+            for (auto& refinement : refinements) {
+                std::sort(refinement.begin(), refinement.end(),
+                    [](const InvariantPart& lhs, const InvariantPart& rhs) {return lhs.predicate < rhs.predicate;});
+                if (seen_candidates.size() < max_invariant_candidates && seen_candidates.insert(key(refinement)).second)
+                    candidates.push_back(refinement);
+            }
+        }
+
+        // keeps the groups with exactly one atom in the initial state
+        std::map<std::pair<std::size_t, std::vector<std::string>>, std::size_t> group_sizes;
+        for (const auto& atom : init_) {
+            for (std::size_t i = 0; i < invariants.size(); ++i) {
+                for (const auto& part : invariants[i]) {
+                    if (part.predicate != atom.predicate) continue;
+                    std::vector<std::string> parameters;
+                    for (int pos : part.order) parameters.push_back(atom.args.at(pos));
+                    ++group_sizes[std::make_pair(i, parameters)];
+                }
+            }
+        }
+
+        std::vector<std::vector<Atom>> groups;
+        for (const auto& group : group_sizes) {
+            if (group.second != 1) continue;
+            std::vector<Atom> atoms;
+            for (const auto& part : invariants[group.first.first]) {
+                Atom atom {part.predicate, std::vector<std::string>(part.order.size() + (part.omitted_pos != -1), "?X")};
+                for (std::size_t i = 0; i < part.order.size(); ++i) atom.args[part.order[i]] = group.first.second[i];
+                atoms.push_back(atom);
+            }
+            groups.push_back(atoms);
+        }
+        return groups;
+    }
+
+    void PddlGrounder::ensure_conjunction_sat(ConstraintSystem& system, const std::vector<Literal>& literals) {
+        std::map<std::string, std::vector<const Literal*>> positive, negative;
+        for (const auto& literal : literals) {
+            if (literal.predicate == "=") {
+                Equalities equality(1, std::make_pair(literal.args.at(0), literal.args.at(1)));
+                if (literal.negated) system.negative_clauses.push_back(equality);
+                else system.assignments.push_back(std::vector<Equalities>(1, equality));
+            } else {
+                (literal.negated ? negative : positive)[literal.predicate].push_back(&literal);
+            }
+        }
+        for (const auto& predicate : positive) {
+            auto negated = negative.find(predicate.first);
+            if (negated == negative.end()) continue;
+            for (const Literal* positive_literal : predicate.second) {
+                for (const Literal* negative_literal : negated->second) {
+                    Equalities clause;
+                    for (std::size_t i = 0; i < positive_literal->args.size(); ++i)
+                        clause.push_back(std::make_pair(negative_literal->args[i], positive_literal->args[i]));
+                    if (!clause.empty()) system.negative_clauses.push_back(clause);
+                }
+            }
+        }
+    }
+
+    bool PddlGrounder::balanced(const Invariant& invariant, std::vector<Invariant>& refinements) const {
+        auto part_of = [&](const std::string& predicate) -> const InvariantPart* {
+            for (const auto& part : invariant) if (part.predicate == predicate) return &part;
+            return nullptr;
+        };
+
+        for (const auto& schema : schemas_) {
+            // only actions adding some atom of the invariant threaten it
+            std::vector<const Literal*> add_effects, delete_effects;
+            for (const auto& effect : schema.effects) {
+                if (!part_of(effect.predicate)) continue;
+                (effect.negated ? delete_effects : add_effects).push_back(&effect);
+            }
+            if (add_effects.empty()) continue;
+
+            // unique names for the variables of the invariant
+            std::vector<std::string> invariant_vars;
+            for (int counter = 0; invariant_vars.size() < invariant.front().order.size(); ++counter) {
+                std::string name = "?v" + std::to_string(counter);
+                bool taken = false;
+                for (const auto& parameter : schema.parameters) taken = taken || parameter.first == name;
+                if (!taken) invariant_vars.push_back(name);
+            }
+
+            auto covering = [&](const Literal& literal) {
+                const InvariantPart* part = part_of(literal.predicate);
+                Equalities assignment;
+                for (std::size_t i = 0; i < part->order.size(); ++i)
+                    assignment.push_back(std::make_pair(invariant_vars[i], literal.args.at(part->order[i])));
+                return assignment;
+            };
+
+            auto negate = [](const Literal& literal) {
+                return Literal {literal.predicate, literal.args, !literal.negated};
+            };
+
+            // too heavy, i.e. two atoms of the invariant may be added at once
+            for (std::size_t i = 0; i < add_effects.size(); ++i) {
+                for (std::size_t j = i + 1; j < add_effects.size(); ++j) {
+                    ConstraintSystem system;
+                    system.assignments.push_back(std::vector<Equalities>(1, covering(*add_effects[i])));
+                    system.assignments.push_back(std::vector<Equalities>(1, covering(*add_effects[j])));
+                    std::vector<Literal> literals(schema.precondition);
+                    literals.push_back(negate(*add_effects[i]));
+                    literals.push_back(negate(*add_effects[j]));
+                    ensure_conjunction_sat(system, literals);
+                    if (system.is_solvable()) return false;
+                }
+            }
+
+            // unbalanced, i.e. an atom of the invariant may be added without
+            // deleting another one
+            for (const Literal* add_effect : add_effects) {
+                Equalities add_covering = covering(*add_effect);
+                std::map<std::string, std::string> mapping;
+                get_mapping(add_covering, mapping);
+                auto mapped = [&](const std::string& x) {
+                    auto it = mapping.find(x);
+                    return it == mapping.end() ? x : it->second;
+                };
+
+                // minimal renaming of the parameters such that the add effect is covered
+                ConstraintSystem renaming;
+                renaming.assignments.push_back(std::vector<Equalities>(1, add_covering));
+                for (std::size_t i = 0; i < schema.parameters.size(); ++i) {
+                    for (std::size_t j = i + 1; j < schema.parameters.size(); ++j) {
+                        const std::string& first = schema.parameters[i].first;
+                        const std::string& second = schema.parameters[j].first;
+                        if (mapped(first) != mapped(second))
+                            renaming.negative_clauses.push_back(Equalities(1, std::make_pair(first, second)));
+                    }
+                }
+
+                std::vector<Literal> lhs(schema.precondition);
+                lhs.push_back(negate(*add_effect));
+
+                bool unbalanced = true;
+                for (const Literal* delete_effect : delete_effects) {
+                    ConstraintSystem system;
+                    system.assignments.push_back(std::vector<Equalities>(1, covering(*delete_effect)));
+                    system.combine(renaming);
+
+                    ConstraintSystem lhs_system(renaming);
+                    ensure_conjunction_sat(lhs_system, lhs);
+                    if (lhs_system.is_solvable()) {
+                        // the precondition must imply the deleted atom
+                        std::vector<Equalities> implications;
+                        for (const auto& literal : lhs) {
+                            if (literal.negated || literal.predicate != delete_effect->predicate) continue;
+                            Equalities implication;
+                            for (std::size_t i = 0; i < literal.args.size(); ++i)
+                                implication.push_back(std::make_pair(delete_effect->args.at(i), literal.args[i]));
+                            implications.push_back(implication);
+                        }
+                        if (implications.empty()) continue;
+                        system.assignments.push_back(implications);
+                    }
+                    if (system.is_solvable()) {
+                        unbalanced = false;
+                        break;
+                    }
+                }
+                if (!unbalanced) continue;
+
+                // refines the candidate with the atoms deleted by the action
+                const InvariantPart* part = part_of(add_effect->predicate);
+                for (const auto& delete_effect : schema.effects) {
+                    if (!delete_effect.negated || part_of(delete_effect.predicate)) continue;
+                    for (const auto& match : get_matches(*part, *add_effect, delete_effect)) {
+                        refinements.push_back(invariant);
+                        refinements.back().push_back(match);
+                    }
+                }
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::vector<PddlGrounder::InvariantPart> PddlGrounder::get_matches(
+        const InvariantPart& part,
+        const Literal& own_literal,
+        const Literal& other_literal
+    ) {
+        int allowed_omissions = static_cast<int>(other_literal.args.size()) - static_cast<int>(part.order.size());
+        if (allowed_omissions != 0 && allowed_omissions != 1) return {};
+
+        std::map<std::string, std::vector<int>> own_positions_of;
+        for (std::size_t i = 0; i < part.order.size(); ++i)
+            own_positions_of[own_literal.args.at(part.order[i])].push_back(i);
+        std::vector<std::pair<std::string, std::vector<int>>> other_positions_of;
+        for (std::size_t i = 0; i < other_literal.args.size(); ++i) {
+            auto it = std::find_if(other_positions_of.begin(), other_positions_of.end(),
+                [&](const std::pair<std::string, std::vector<int>>& entry) {return entry.first == other_literal.args[i];});
+            if (it == other_positions_of.end()) other_positions_of.push_back(std::make_pair(other_literal.args[i], std::vector<int>(1, i)));
+            else it->second.push_back(i);
+        }
+
+        // each argument of the other literal maps to a position of the part
+        // with the same argument, or to the omitted position
+        std::vector<std::vector<std::vector<std::pair<int, int>>>> factored_mapping;
+        for (const auto& entry : other_positions_of) {
+            std::vector<int> own_positions = own_positions_of[entry.first];
+            int length_difference = static_cast<int>(own_positions.size()) - static_cast<int>(entry.second.size());
+            if (length_difference >= 1 || length_difference <= -2 || (length_difference == -1 && !allowed_omissions)) return {};
+            if (length_difference) {
+                own_positions.push_back(-1);
+                allowed_omissions = 0;
+            }
+            std::vector<std::vector<std::pair<int, int>>> permutations;
+            std::vector<std::size_t> permutation(own_positions.size());
+            for (std::size_t i = 0; i < permutation.size(); ++i) permutation[i] = i;
+            do {
+                std::vector<std::pair<int, int>> mapping;
+                for (std::size_t i = 0; i < permutation.size(); ++i)
+                    mapping.push_back(std::make_pair(entry.second[i], own_positions[permutation[i]]));
+                permutations.push_back(mapping);
+            } while (std::next_permutation(permutation.begin(), permutation.end()));
+            factored_mapping.push_back(permutations);
+        }
+
+        std::vector<std::vector<std::pair<int, int>>> mappings(1);
+        for (auto factor = factored_mapping.rbegin(); factor != factored_mapping.rend(); ++factor) {
+            std::vector<std::vector<std::pair<int, int>>> new_mappings;
+            for (const auto& item : *factor) {
+                for (const auto& mapping : mappings) {
+                    new_mappings.push_back(item);
+                    new_mappings.back().insert(new_mappings.back().end(), mapping.begin(), mapping.end());
+                }
+            }
+            mappings = std::move(new_mappings);
+        }
+
+        std::vector<InvariantPart> matches;
+        for (const auto& mapping : mappings) {
+            InvariantPart match {other_literal.predicate, std::vector<int>(part.order.size()), -1};
+            for (const auto& pair : mapping) {
+                if (pair.second == -1) match.omitted_pos = pair.first;
+                else match.order[pair.second] = pair.first;
+            }
+            matches.push_back(match);
+        }
+        return matches;
+    }
+}
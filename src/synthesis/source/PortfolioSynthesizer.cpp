@@ -0,0 +1,135 @@
+/*
+ * Definition of class PortfolioSynthesizer
+*/
+
+#include"PortfolioSynthesizer.h"
+
+#include<atomic>
+#include<iostream>
+#include<mutex>
+#include<sstream>
+#include<stdexcept>
+#include<thread>
+
+namespace Syft {
+
+    PortfolioSynthesizer::PortfolioSynthesizer(
+        const std::string& domain_file,
+        const std::string& problem_file,
+        const std::vector<PortfolioConfiguration>& configurations,
+        const std::string& cache_dir,
+        bool prune
+    ) : domain_file_(domain_file),
+        problem_file_(problem_file),
+        cache_dir_(cache_dir),
+        prune_(prune),
+        configurations_(configurations),
+        winner_id_(0) {}
+
+    std::vector<PortfolioConfiguration> PortfolioSynthesizer::default_configurations() {
+        ReorderingPolicy sift;
+
+        // action bits, reaction bits and mutex groups moved as units
+        ReorderingPolicy group_sift;
+        group_sift.method = ReorderingMethod::GroupSift;
+        group_sift.variable_groups = true;
+
+        ReorderingPolicy window;
+        window.method = ReorderingMethod::Window;
+
+        // the order found once the domain DFA is built is kept in synthesis
+        ReorderingPolicy frozen;
+        frozen.reorder_after_construction = true;
+        frozen.synthesis_reorderings = 0;
+
+        std::vector<PortfolioConfiguration> configurations = {
+            {"automatic", SynthesisEngine::Automatic, false, 0, false, false,
+                VariableOrderHeuristic::Creation, sift},
+            {"partitioned-fused-interaction", SynthesisEngine::Partitioned, false, 0, true, false,
+                VariableOrderHeuristic::Interaction, sift},
+            {"monolithic-frontier-fused-force-groups", SynthesisEngine::Monolithic, true, 0, true, false,
+                VariableOrderHeuristic::Force, group_sift},
+            {"on-the-fly-window", SynthesisEngine::OnTheFly, false, 0, false, false,
+                VariableOrderHeuristic::Creation, window},
+            {"conjunctive-reachable-frozen", SynthesisEngine::Monolithic, false, 5000, true, true,
+                VariableOrderHeuristic::Interaction, frozen}
+        };
+
+        std::size_t cores = std::thread::hardware_concurrency();
+        if (cores > 0 && cores < configurations.size()) configurations.resize(cores);
+        return configurations;
+    }
+
+    SynthesisResult PortfolioSynthesizer::run() {
+        if (configurations_.empty()) throw std::runtime_error("Empty portfolio");
+
+        std::atomic<bool> cancelled(false);
+        std::mutex result_mutex;
+        SynthesisResult result;
+        bool terminated = false;
+
+        // the progress lines of each worker are buffered, only those of the
+        // winner are printed
+        std::vector<std::ostringstream> logs(configurations_.size());
+        std::vector<std::shared_ptr<VarMgr>> var_mgrs;
+        std::vector<std::unique_ptr<FONDSynthesizer>> synthesizers;
+        for (const auto& configuration : configurations_) {
+            std::shared_ptr<VarMgr> var_mgr = std::make_shared<VarMgr>();
+            var_mgr->set_reordering_policy(configuration.reordering);
+            var_mgr->set_cancellation_flag(&cancelled);
+            var_mgrs.push_back(var_mgr);
+            synthesizers.push_back(std::make_unique<FONDSynthesizer>(
+                var_mgr,
+                domain_file_,
+                problem_file_,
+                false,
+                configuration.frontier,
+                configuration.engine,
+                configuration.cluster_threshold,
+                configuration.fused,
+                configuration.forward_reachability,
+                false,
+                cache_dir_,
+                prune_,
+                false,
+                configuration.var_order));
+            synthesizers.back()->set_log(logs[synthesizers.size() - 1]);
+        }
+
+        std::vector<std::thread> workers;
+        for (std::size_t i = 0; i < synthesizers.size(); ++i) {
+            workers.emplace_back([&, i]() {
+                try {
+                    SynthesisResult worker_result = synthesizers[i]->run();
+                    std::lock_guard<std::mutex> result_lock(result_mutex);
+                    if (!terminated) {
+                        terminated = true;
+                        winner_id_ = i;
+                        result = std::move(worker_result);
+                        cancelled = true;
+                    }
+                } catch (const std::exception& e) {
+                    // cancelled workers end here, since CUDD reports the
+                    // termination through its error handler and the loops
+                    // outside CUDD throw once the flag is set
+                    if (!cancelled) std::cerr << "[syft4fond] Portfolio configuration "
+                        << configurations_[i].name << " failed: " << e.what() << std::endl;
+                }
+            });
+        }
+        for (auto& worker : workers) worker.join();
+
+        // cancelled refers to this scope, while the manager of the winner
+        // outlives it through the result
+        for (const auto& var_mgr : var_mgrs) var_mgr->set_cancellation_flag(nullptr);
+
+        if (!terminated) throw std::runtime_error("No portfolio configuration terminated");
+
+        // the synthesizers of the other configurations, and their managers,
+        // are destroyed when synthesizers goes out of scope
+        std::cout << logs[winner_id_].str() << std::flush;
+        winner_ = std::move(synthesizers[winner_id_]);
+        winner_->set_log(std::cout);
+        return result;
+    }
+}
@@ -1,9 +1,15 @@
 #include "Quantification.h"
 
 #include <memory>
+#include <utility>
 
 namespace Syft {
 
+CUDD::BDD Quantification::and_apply(const CUDD::BDD& f,
+                                    const CUDD::BDD& g) const {
+  return apply(f & g);
+}
+
 CUDD::BDD NoQuantification::apply(const CUDD::BDD& bdd) const {
   return bdd;
 }
@@ -24,6 +30,10 @@ CUDD::BDD Exists::apply(const CUDD::BDD& bdd) const {
   return bdd.ExistAbstract(existential_variables_);
 }
 
+CUDD::BDD Exists::and_apply(const CUDD::BDD& f, const CUDD::BDD& g) const {
+  return f.AndAbstract(g, existential_variables_);
+}
+
 ForallExists::ForallExists(CUDD::BDD universal_variables,
 			   CUDD::BDD existential_variables)
   : forall_(std::move(universal_variables))
@@ -43,6 +53,11 @@ ExistsExists::ExistsExists(CUDD::BDD existential_variables_a,
 CUDD::BDD ExistsExists::apply(const CUDD::BDD &bdd) const {
   return exists_a_.apply(exists_b_.apply(bdd));
 }
+
+CUDD::BDD ExistsExists::and_apply(const CUDD::BDD &f,
+                                  const CUDD::BDD &g) const {
+  return exists_a_.apply(exists_b_.and_apply(f, g));
+}
 // END
 
 ExistsForall::ExistsForall(CUDD::BDD existential_variables,
@@ -1,17 +1,25 @@
 #include "ReachabilitySynthesizer.h"
 
 #include <cassert>
+#include <utility>
+#include <vector>
+
+#include "Stopwatch.h"
 
 namespace Syft {
 
 ReachabilitySynthesizer::ReachabilitySynthesizer(SymbolicStateDfa spec,
 						 Player starting_player, Player protagonist_player,
 						 CUDD::BDD goal_states,
-						 CUDD::BDD state_space)
-    : DfaGameSynthesizer(spec, starting_player, protagonist_player)
+						 CUDD::BDD state_space,
+						 bool frontier,
+						 std::size_t cluster_threshold,
+						 bool fused)
+    : DfaGameSynthesizer(spec, starting_player, protagonist_player, cluster_threshold)
     , goal_states_(goal_states), state_space_(state_space),
     winning_states_(spec_.var_mgr()->cudd_mgr()->bddZero()),
-    winning_moves_(spec_.var_mgr()->cudd_mgr()->bddZero())
+    winning_moves_(spec_.var_mgr()->cudd_mgr()->bddZero()),
+    frontier_(frontier), fused_(fused), iterations_(0)
 {}
 
 
@@ -20,22 +28,70 @@ SynthesisResult ReachabilitySynthesizer::run() {
   CUDD::BDD winning_states = state_space_ & goal_states_;
   CUDD::BDD winning_moves = winning_states;
 
-  // std::size_t iteration = 0;
+  // In frontier mode, winning_transitions accumulates the composition of the
+  // transition function with all the states won so far. Composition distributes
+  // over disjunction, hence each iteration only composes the states won in the
+  // previous one
+  CUDD::BDD winning_transitions = var_mgr_->cudd_mgr()->bddZero();
+  CUDD::BDD old_winning_states = var_mgr_->cudd_mgr()->bddZero();
+
+  // In fused mode, the moves are only needed for the strategy, hence the
+  // winning states and the preimage of each iteration are kept, and the moves
+  // are conjoined once the fixpoint ends
+  std::vector<std::pair<CUDD::BDD, CUDD::BDD>> layers;
+  auto conjoin_moves = [&]() {
+    CUDD::BDD moves = winning_moves;
+    for (const auto& layer : layers)
+      moves |= state_space_ & (!layer.first) & layer.second;
+    return moves;
+  };
+
+  iterations_ = 0;
+  iteration_times_.clear();
   while (true) {
-    // std::cout << "Current fixpoint iteration (adversarial): " << iteration << std::endl;
+    Stopwatch iteration_time;
+    iteration_time.start();
+    ++iterations_;
+    // std::cout << "Current fixpoint iteration (adversarial): " << iterations_ << std::endl;
     // std::cout << "Computing preimage... " << std::flush;
-    CUDD::BDD preimage_bdd = preimage(winning_states);
+    CUDD::BDD preimage_bdd;
+    if (frontier_) {
+      // the restriction agrees with winning_states outside old_winning_states,
+      // transitions into old_winning_states are already in winning_transitions
+      CUDD::BDD frontier = winning_states.Restrict(!old_winning_states);
+      winning_transitions = winning_transitions | compose(frontier);
+      old_winning_states = winning_states;
+      preimage_bdd = quantify_independent_variables_->apply(winning_transitions);
+    } else {
+      preimage_bdd = preimage(winning_states);
+    }
     // std::cout << "Done!" << std::endl;
     // std::cout << "Quantification elimination..." << std::flush;
-    CUDD::BDD new_winning_moves = winning_moves | (state_space_ & (!winning_states) & preimage_bdd);
-//     CUDD::BDD new_winning_moves = winning_moves |
+    CUDD::BDD new_winning_moves;
+    CUDD::BDD new_winning_states;
+    if (fused_) {
+      // The new moves are from states outside winning_states, hence projecting
+      // them separately from the old moves gives the same winning states. The
+      // conjunction with the preimage is fused with the quantification
+      layers.emplace_back(winning_states, preimage_bdd);
+      new_winning_states = winning_states |
+        quantify_non_state_variables_->and_apply(state_space_ & (!winning_states),
+                                                 preimage_bdd);
+    } else {
+      new_winning_moves = winning_moves | (state_space_ & (!winning_states) & preimage_bdd);
+//       CUDD::BDD new_winning_moves = winning_moves |
                               //     (state_space_ & (!winning_states) & preimage(winning_states));
-    // std::cout << "Done!" << std::endl;
-
-    CUDD::BDD new_winning_states = project_into_states(new_winning_moves);
+      new_winning_states = project_into_states(new_winning_moves);
+    }
 //     std::cout <<"Done!" << std::endl;
+    iteration_times_.push_back(iteration_time.stop().count() / 1000.0);
+
+    bool realizable = includes_initial_state(new_winning_states);
+    if (fused_ && (realizable || new_winning_states == winning_states)) {
+        new_winning_moves = conjoin_moves();
+    }
 
-    if (includes_initial_state(new_winning_states)) {
+    if (realizable) {
         result.realizability = true;
         result.winning_states = new_winning_states;
         std::unordered_map<int, CUDD::BDD> strategy = synthesize_strategy(
@@ -62,10 +118,8 @@ SynthesisResult ReachabilitySynthesizer::run() {
         return result;
     }
 
-    winning_moves = new_winning_moves;
+    if (!fused_) winning_moves = new_winning_moves;
     winning_states = new_winning_states;
-
-    // ++iteration; 
   }
 
 }
@@ -78,4 +132,12 @@ SynthesisResult ReachabilitySynthesizer::run() {
       return winning_moves_;
  }
 
+ std::size_t ReachabilitySynthesizer::get_iterations() const {
+      return iterations_;
+ }
+
+ std::vector<double> ReachabilitySynthesizer::get_iteration_times() const {
+      return iteration_times_;
+ }
+
 }
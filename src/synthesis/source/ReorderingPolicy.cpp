@@ -0,0 +1,39 @@
+#include "ReorderingPolicy.h"
+
+namespace Syft {
+
+Cudd_ReorderingType ReorderingPolicy::cudd_method() const {
+  switch (method) {
+    case ReorderingMethod::SymmetricSift: return CUDD_REORDER_SYMM_SIFT;
+    case ReorderingMethod::GroupSift: return CUDD_REORDER_GROUP_SIFT;
+    case ReorderingMethod::Window: return CUDD_REORDER_WINDOW3;
+    case ReorderingMethod::Annealing: return CUDD_REORDER_ANNEALING;
+    default: return CUDD_REORDER_SIFT;
+  }
+}
+
+Cudd_ReorderingType ReorderingPolicy::converging_cudd_method() const {
+  switch (method) {
+    case ReorderingMethod::SymmetricSift: return CUDD_REORDER_SYMM_SIFT_CONV;
+    case ReorderingMethod::GroupSift: return CUDD_REORDER_GROUP_SIFT_CONV;
+    case ReorderingMethod::Window: return CUDD_REORDER_WINDOW3_CONV;
+    // annealing has no converging variant
+    case ReorderingMethod::Annealing: return CUDD_REORDER_ANNEALING;
+    default: return CUDD_REORDER_SIFT_CONVERGE;
+  }
+}
+
+ReorderingCounter::ReorderingCounter(std::shared_ptr<CUDD::Cudd> mgr)
+    : mgr_(std::move(mgr)),
+      start_reorderings_(mgr_->ReadReorderings()),
+      start_time_(mgr_->ReadReorderingTime()) {}
+
+unsigned int ReorderingCounter::reorderings() const {
+  return mgr_->ReadReorderings() - start_reorderings_;
+}
+
+double ReorderingCounter::seconds() const {
+  return (mgr_->ReadReorderingTime() - start_time_) / 1000.0;
+}
+
+}
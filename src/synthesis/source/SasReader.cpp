@@ -0,0 +1,131 @@
+/*
+* Definition of class SasReader
+*/
+
+#include"SasReader.h"
+
+#include<cctype>
+#include<charconv>
+#include<cstring>
+#include<stdexcept>
+#include<fcntl.h>
+#include<sys/mman.h>
+#include<sys/stat.h>
+#include<unistd.h>
+
+namespace Syft {
+
+    namespace {
+
+        // splits line at single spaces into at most max_tokens tokens,
+        // returns the number of tokens, which exceeds max_tokens if any is left
+        std::size_t split_spaces(std::string_view line, std::string_view* tokens, std::size_t max_tokens) {
+            std::size_t count = 0;
+            while (true) {
+                std::size_t space = line.find(' ');
+                if (count < max_tokens) tokens[count] = line.substr(0, space);
+                ++count;
+                if (space == std::string_view::npos) return count;
+                line.remove_prefix(space + 1);
+            }
+        }
+
+        int to_int(std::string_view token) {
+            int value = 0;
+            auto result = std::from_chars(token.data(), token.data() + token.size(), value);
+            if (result.ec != std::errc()) throw std::runtime_error("Invalid integer in SAS file: " + std::string(token));
+            return value;
+        }
+
+        std::string_view trim(std::string_view line) {
+            while (!line.empty() && std::isspace(static_cast<unsigned char>(line.front()))) line.remove_prefix(1);
+            while (!line.empty() && std::isspace(static_cast<unsigned char>(line.back()))) line.remove_suffix(1);
+            return line;
+        }
+
+        bool starts_with(std::string_view line, std::string_view prefix) {
+            return line.substr(0, prefix.size()) == prefix;
+        }
+    }
+
+    SasReader::SasReader(const std::string& sas_file): begin_(nullptr), end_(nullptr), mapped_size_(0) {
+        int fd = open(sas_file.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error("Unable to open SAS file " + sas_file);
+
+        struct stat file_stat;
+        if (fstat(fd, &file_stat) < 0) {
+            close(fd);
+            throw std::runtime_error("Unable to stat SAS file " + sas_file);
+        }
+
+        // an empty file cannot be mapped, and holds an empty task
+        if (file_stat.st_size > 0) {
+            void* mapped = mmap(nullptr, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped == MAP_FAILED) {
+                close(fd);
+                throw std::runtime_error("Unable to map SAS file " + sas_file);
+            }
+            madvise(mapped, file_stat.st_size, MADV_SEQUENTIAL);
+            mapped_size_ = file_stat.st_size;
+            begin_ = static_cast<const char*>(mapped);
+            end_ = begin_ + mapped_size_;
+        }
+        close(fd);
+    }
+
+    SasReader::~SasReader() {
+        if (mapped_size_ > 0) munmap(const_cast<char*>(begin_), mapped_size_);
+    }
+
+    std::string_view SasReader::next_line(const char*& cursor) const {
+        const char* line_begin = cursor;
+        const char* line_end = static_cast<const char*>(std::memchr(cursor, '\n', end_ - cursor));
+        if (line_end == nullptr) {
+            cursor = end_;
+            return std::string_view(line_begin, end_ - line_begin);
+        }
+        cursor = line_end + 1;
+        return std::string_view(line_begin, line_end - line_begin);
+    }
+
+    GroundTask SasReader::read() const {
+        GroundTask task;
+        std::string_view tokens[4];
+        const char* cursor = begin_;
+        while (cursor < end_) {
+            std::string_view line = next_line(cursor);
+            if (starts_with(line, "Atom")) {
+                task.atoms.emplace_back(line.substr(5));
+            } else if (starts_with(line, "begin_state")) { // reads initial state information
+                while (cursor < end_ && line != "end_state") {
+                    line = next_line(cursor);
+                    if (line == "0") task.init.push_back(0);
+                    else if (line == "1") task.init.push_back(1);
+                }
+            } else if (starts_with(line, "begin_operator")) { // reads action information
+                GroundOperator op;
+                while (cursor < end_ && line != "end_operator") {
+                    line = next_line(cursor);
+                    if (starts_with(line, "  ")) {
+                        // "  v<var>: <value>" is a precondition,
+                        // "  v<var>: <pre> -> <post>" is an effect
+                        std::size_t token_count = split_spaces(trim(line), tokens, 4);
+                        if (token_count != 2 && token_count != 4) continue;
+                        int var = to_int(tokens[0].substr(1, tokens[0].size() - 2));
+                        if (token_count == 2) op.prevail.emplace_back(var, to_int(tokens[1]));
+                        else op.pre_post.emplace_back(var, to_int(tokens[1]), to_int(tokens[3]));
+                    } else if (line != "end_operator") {
+                        op.name = std::string(line);
+                    }
+                }
+                task.operators.push_back(std::move(op));
+            } else if (starts_with(line, "begin_goal")) { // reads goal information
+                while (cursor < end_ && line != "end_goal") {
+                    line = next_line(cursor);
+                    if (split_spaces(line, tokens, 4) == 2) task.goal.emplace_back(to_int(tokens[0]), to_int(tokens[1]));
+                }
+            }
+        }
+        return task;
+    }
+}
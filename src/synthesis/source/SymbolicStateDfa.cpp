@@ -1,5 +1,11 @@
 #include "SymbolicStateDfa.h"
 
+#include <algorithm>
+#include <stdexcept>
+
+#include "BddSerializer.h"
+#include "TransitionRelation.h"
+
 namespace Syft {
 
 SymbolicStateDfa::SymbolicStateDfa(std::shared_ptr<VarMgr> var_mgr)
@@ -152,6 +158,72 @@ CUDD::BDD SymbolicStateDfa::initial_state_bdd() const {
   return state_to_bdd(var_mgr_, automaton_id_, 0);
 }
 
+CUDD::BDD SymbolicStateDfa::image(const CUDD::BDD& states) const {
+  if (states.IsZero()) return states;
+
+  // The generalized cofactor maps every assignment outside of states to one
+  // inside, hence the constrained functions have the same range over all
+  // assignments as the original ones over states (Coudert and Madre)
+  std::vector<CUDD::BDD> functions;
+  functions.reserve(transition_function_.size());
+  for (const auto& bit_function : transition_function_)
+    functions.push_back(bit_function.Constrain(states));
+  RangeCache cache;
+  return range(functions, 0, cache);
+}
+
+bool SymbolicStateDfa::BddVectorLess::operator()(
+    const std::vector<CUDD::BDD>& lhs, const std::vector<CUDD::BDD>& rhs) const {
+  return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(),
+    [](const CUDD::BDD& l, const CUDD::BDD& r) { return l.getNode() < r.getNode(); });
+}
+
+CUDD::BDD SymbolicStateDfa::range(const std::vector<CUDD::BDD>& functions,
+                                  std::size_t i, RangeCache& cache) const {
+  // The key holds references to the functions, so their nodes are not reused
+  std::vector<CUDD::BDD> key(functions.begin() + i, functions.end());
+  auto cached = cache.find(key);
+  if (cached != cache.end()) return cached->second;
+
+  // State variables with a constant value do not split the range
+  CUDD::BDD fixed = var_mgr_->cudd_mgr()->bddOne();
+  std::size_t j = i;
+  while (j < functions.size() && (functions[j].IsOne() || functions[j].IsZero())) {
+    CUDD::BDD variable = var_mgr_->state_variable(automaton_id_, j);
+    fixed &= functions[j].IsOne() ? variable : !variable;
+    ++j;
+  }
+
+  CUDD::BDD result = fixed;
+  if (j < functions.size()) {
+    std::vector<CUDD::BDD> positive(functions), negative(functions);
+    for (std::size_t k = j + 1; k < functions.size(); ++k) {
+      positive[k] = functions[k].Constrain(functions[j]);
+      negative[k] = functions[k].Constrain(!functions[j]);
+    }
+    result &= var_mgr_->state_variable(automaton_id_, j).Ite(
+      range(positive, j + 1, cache), range(negative, j + 1, cache));
+  }
+  cache.emplace(std::move(key), result);
+  return result;
+}
+
+CUDD::BDD SymbolicStateDfa::reachable_states(const CUDD::BDD& state_space,
+                                             std::size_t cluster_threshold) const {
+  TransitionRelation transition_relation(var_mgr_, automaton_id_,
+                                         transition_function_, cluster_threshold);
+
+  // Only the image of the states reached in the last iteration is computed
+  CUDD::BDD reachable = var_mgr_->state_vector_to_bdd(automaton_id_, initial_state_);
+  CUDD::BDD frontier = reachable;
+  while (!frontier.IsZero()) {
+    frontier = transition_relation.image(frontier) & state_space & (!reachable);
+    reachable |= frontier;
+  }
+
+  return reachable;
+}
+
 CUDD::BDD SymbolicStateDfa::final_states() const {
   return final_states_;
 }
@@ -289,5 +361,36 @@ SymbolicStateDfa SymbolicStateDfa::restriction(const CUDD::BDD& invalid_states)
 
 }
 
+void SymbolicStateDfa::save(std::ostream& out) const {
+  BddSerializer::write_magic(out, "SYFTDFA1");
+  BddSerializer::write_uint(out, automaton_id_);
+  BddSerializer::write_uint(out, initial_state_.size());
+  for (int value : initial_state_) BddSerializer::write_uint(out, value);
+
+  std::vector<CUDD::BDD> bdds = transition_function_;
+  bdds.push_back(final_states_);
+  BddSerializer::write(out, var_mgr_->cudd_mgr(), bdds);
+}
+
+SymbolicStateDfa SymbolicStateDfa::load(std::istream& in,
+                                        std::shared_ptr<VarMgr> var_mgr) {
+  BddSerializer::read_magic(in, "SYFTDFA1");
+  std::size_t automaton_id = BddSerializer::read_uint(in);
+  if (automaton_id >= var_mgr->automaton_num())
+    throw std::runtime_error("Unknown automaton ID in DFA stream");
+
+  std::vector<int> initial_state(BddSerializer::read_uint(in));
+  for (int& value : initial_state) value = BddSerializer::read_uint(in);
+
+  std::vector<CUDD::BDD> bdds = BddSerializer::read(in, var_mgr->cudd_mgr());
+  if (bdds.size() != initial_state.size() + 1)
+    throw std::runtime_error("Malformed DFA stream");
+  CUDD::BDD final_states = bdds.back();
+  bdds.pop_back();
+
+  return SymbolicStateDfa(std::move(var_mgr), automaton_id, initial_state,
+                          bdds, final_states);
+}
+
 }
 
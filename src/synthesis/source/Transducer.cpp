@@ -2,6 +2,10 @@
 
 #include <cstring>
 #include <iostream>
+#include <map>
+#include <stdexcept>
+
+#include "BddSerializer.h"
 
 namespace Syft {
 
@@ -43,4 +47,51 @@ void Transducer::dump_dot(const std::string& filename) const {
 
   var_mgr_->dump_dot(output_vector, output_labels, filename);
   }
+void Transducer::save(std::ostream& out) const {
+  BddSerializer::write_magic(out, "SYFTTRD1");
+  BddSerializer::write_uint(out, initial_vector_.size());
+  for (int value : initial_vector_) BddSerializer::write_uint(out, value);
+  BddSerializer::write_uint(out, static_cast<std::uint64_t>(starting_player_));
+  BddSerializer::write_uint(out, static_cast<std::uint64_t>(protagonist_player_));
+
+  // output BDDs in the order of their variable indices, then the
+  // transition function
+  std::map<int, CUDD::BDD> sorted_outputs(output_function_.begin(),
+                                          output_function_.end());
+  std::vector<CUDD::BDD> bdds;
+  BddSerializer::write_uint(out, sorted_outputs.size());
+  for (const auto& index_and_bdd : sorted_outputs) {
+    BddSerializer::write_uint(out, index_and_bdd.first);
+    bdds.push_back(index_and_bdd.second);
+  }
+  bdds.insert(bdds.end(), transition_function_.begin(), transition_function_.end());
+  BddSerializer::write(out, var_mgr_->cudd_mgr(), bdds);
+}
+
+std::unique_ptr<Transducer> Transducer::load(std::istream& in,
+                                             std::shared_ptr<VarMgr> var_mgr) {
+  BddSerializer::read_magic(in, "SYFTTRD1");
+  std::vector<int> initial_vector(BddSerializer::read_uint(in));
+  for (int& value : initial_vector) value = BddSerializer::read_uint(in);
+  Player starting_player = static_cast<Player>(BddSerializer::read_uint(in));
+  Player protagonist_player = static_cast<Player>(BddSerializer::read_uint(in));
+
+  std::vector<int> output_indices(BddSerializer::read_uint(in));
+  for (int& index : output_indices) index = BddSerializer::read_uint(in);
+
+  std::vector<CUDD::BDD> bdds = BddSerializer::read(in, var_mgr->cudd_mgr());
+  if (bdds.size() < output_indices.size())
+    throw std::runtime_error("Malformed transducer stream");
+
+  std::unordered_map<int, CUDD::BDD> output_function;
+  for (std::size_t i = 0; i < output_indices.size(); ++i)
+    output_function[output_indices[i]] = bdds[i];
+  std::vector<CUDD::BDD> transition_function(bdds.begin() + output_indices.size(),
+                                             bdds.end());
+
+  return std::make_unique<Transducer>(std::move(var_mgr), initial_vector,
+                                      output_function, transition_function,
+                                      starting_player, protagonist_player);
+}
+
 }
@@ -0,0 +1,143 @@
+#include "TransitionRelation.h"
+
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+namespace Syft {
+
+TransitionRelation::TransitionRelation(
+    std::shared_ptr<VarMgr> var_mgr, std::size_t automaton_id,
+    const std::vector<CUDD::BDD>& transition_function,
+    std::size_t cluster_threshold)
+    : var_mgr_(std::move(var_mgr)) {
+  std::size_t next_state_id = var_mgr_->create_next_state_variables(automaton_id);
+  current_state_variables_ = var_mgr_->get_state_variables(automaton_id);
+  next_state_variables_ = var_mgr_->get_state_variables(next_state_id);
+
+  // Conjoins consecutive bit relations while the cluster fits the threshold.
+  // A bit relation larger than the threshold forms a cluster on its own
+  std::vector<CUDD::BDD> clusters;
+  CUDD::BDD cluster = var_mgr_->cudd_mgr()->bddOne();
+  for (std::size_t i = 0; i < transition_function.size(); ++i) {
+    CUDD::BDD bit_relation = next_state_variables_[i].Xnor(transition_function[i]);
+    CUDD::BDD conjunction = cluster * bit_relation;
+    if (cluster.IsOne() || static_cast<std::size_t>(conjunction.nodeCount()) <= cluster_threshold) {
+      cluster = conjunction;
+    } else {
+      clusters.push_back(cluster);
+      cluster = bit_relation;
+    }
+  }
+  if (!cluster.IsOne()) clusters.push_back(cluster);
+
+  std::vector<unsigned int> current_indices, next_indices;
+  for (const auto& v : current_state_variables_) current_indices.push_back(v.NodeReadIndex());
+  for (const auto& v : next_state_variables_) next_indices.push_back(v.NodeReadIndex());
+
+  // The preimage conjoins a set of next states and quantifies Z', the image
+  // conjoins a set of current states and quantifies Z, X and Y
+  std::vector<unsigned int> image_quantified(current_indices);
+  for (unsigned int index : var_mgr_->input_cube().SupportIndices()) image_quantified.push_back(index);
+  for (unsigned int index : var_mgr_->output_cube().SupportIndices()) image_quantified.push_back(index);
+
+  schedule(clusters, next_indices, next_indices, preimage_clusters_, preimage_cubes_);
+  schedule(clusters, current_indices, image_quantified, image_clusters_, image_cubes_);
+}
+
+void TransitionRelation::schedule(const std::vector<CUDD::BDD>& clusters,
+                                  const std::vector<unsigned int>& initial_support,
+                                  const std::vector<unsigned int>& quantified,
+                                  std::vector<CUDD::BDD>& ordered_clusters,
+                                  std::vector<CUDD::BDD>& cubes) const {
+  std::vector<std::vector<unsigned int>> supports;
+  for (const auto& c : clusters) supports.push_back(c.SupportIndices());
+
+  std::unordered_set<unsigned int> quantified_indices(quantified.begin(), quantified.end());
+  std::unordered_set<unsigned int> product_support(initial_support.begin(), initial_support.end());
+  std::vector<bool> scheduled(clusters.size(), false);
+  std::vector<std::size_t> order;
+
+  for (std::size_t step = 0; step < clusters.size(); ++step) {
+    std::unordered_map<unsigned int, std::size_t> occurrences;
+    for (std::size_t c = 0; c < clusters.size(); ++c) {
+      if (scheduled[c]) continue;
+      for (unsigned int index : supports[c]) {
+        if (quantified_indices.count(index)) ++occurrences[index];
+      }
+    }
+
+    std::size_t best = clusters.size();
+    double best_benefit = 0.0;
+    std::size_t best_introduced = 0;
+    for (std::size_t c = 0; c < clusters.size(); ++c) {
+      if (scheduled[c]) continue;
+      std::size_t quantifiable = 0, introduced = 0;
+      for (unsigned int index : supports[c]) {
+        if (quantified_indices.count(index) && occurrences[index] == 1) ++quantifiable;
+        if (!product_support.count(index)) ++introduced;
+      }
+      double benefit = supports[c].empty() ? 0.0 :
+        static_cast<double>(quantifiable) / supports[c].size();
+      if (best == clusters.size() || benefit > best_benefit ||
+          (benefit == best_benefit && introduced < best_introduced)) {
+        best = c;
+        best_benefit = benefit;
+        best_introduced = introduced;
+      }
+    }
+
+    for (unsigned int index : supports[best]) product_support.insert(index);
+    scheduled[best] = true;
+    order.push_back(best);
+  }
+
+  // Each variable is quantified after the last cluster that depends on it.
+  // Variables no cluster depends on are quantified after the first one
+  std::unordered_map<unsigned int, std::size_t> last_use;
+  for (unsigned int index : quantified) last_use[index] = 0;
+  for (std::size_t step = 0; step < order.size(); ++step) {
+    for (unsigned int index : supports[order[step]]) {
+      if (quantified_indices.count(index)) last_use[index] = step;
+    }
+  }
+
+  std::vector<std::vector<CUDD::BDD>> quantified_variables(order.size());
+  if (!order.empty()) {
+    for (const auto& index_and_step : last_use) {
+      quantified_variables[index_and_step.second].push_back(
+        var_mgr_->cudd_mgr()->bddVar(index_and_step.first));
+    }
+  }
+
+  for (std::size_t step = 0; step < order.size(); ++step) {
+    ordered_clusters.push_back(clusters[order[step]]);
+    cubes.push_back(var_mgr_->cudd_mgr()->computeCube(quantified_variables[step]));
+  }
+}
+
+CUDD::BDD TransitionRelation::preimage(const CUDD::BDD& states) const {
+  return preimage(states, var_mgr_->cudd_mgr()->bddOne());
+}
+
+CUDD::BDD TransitionRelation::preimage(const CUDD::BDD& states,
+                                       const CUDD::BDD& care_states) const {
+  CUDD::BDD product =
+    states.SwapVariables(current_state_variables_, next_state_variables_);
+  if (preimage_clusters_.empty()) return product * care_states;
+  for (std::size_t i = 0; i < preimage_clusters_.size(); ++i) {
+    CUDD::BDD cluster = i == 0 ? preimage_clusters_[0] * care_states : preimage_clusters_[i];
+    product = product.AndAbstract(cluster, preimage_cubes_[i]);
+  }
+  return product;
+}
+
+CUDD::BDD TransitionRelation::image(const CUDD::BDD& states) const {
+  CUDD::BDD product = states;
+  for (std::size_t i = 0; i < image_clusters_.size(); ++i) {
+    product = product.AndAbstract(image_clusters_[i], image_cubes_[i]);
+  }
+  return product.SwapVariables(next_state_variables_, current_state_variables_);
+}
+
+}
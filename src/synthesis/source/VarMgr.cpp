@@ -1,10 +1,14 @@
 #include "VarMgr.h"
 
+#include <algorithm>
 #include <cstring>
+#include <map>
 #include <stdexcept>
 #include <boost/algorithm/string.hpp>
 #include <iostream>
 
+#include "BddSerializer.h"
+
 namespace Syft {
 
 VarMgr::VarMgr() {
@@ -143,6 +147,31 @@ std::size_t VarMgr::create_state_variables(std::size_t variable_count) {
   return automaton_id;
 }
 
+std::size_t VarMgr::create_next_state_variables(std::size_t automaton_id) {
+  auto existing = next_state_ids_.find(automaton_id);
+  if (existing != next_state_ids_.end()) return existing->second;
+
+  std::size_t next_state_id = state_variables_.size();
+  next_state_ids_.emplace(automaton_id, next_state_id);
+  std::size_t variable_count = state_variables_[automaton_id].size();
+
+  state_variables_.emplace_back();
+  state_variables_[next_state_id].reserve(variable_count);
+
+  for (std::size_t i = 0; i < variable_count; ++i) {
+    // Creates a new variable at the level of the i-th state variable, which
+    // is pushed one level down
+    int level = mgr_->ReadPerm(state_variables_[automaton_id][i].NodeReadIndex());
+    CUDD::BDD new_state_variable = mgr_->bddNewVarAtLevel(level);
+
+    state_variables_[next_state_id].push_back(new_state_variable);
+  }
+
+  state_variable_count_ += variable_count;
+
+  return next_state_id;
+}
+
 std::size_t VarMgr::create_product_state_space(
     const std::vector<std::size_t>& automaton_ids) {
   std::size_t product_automaton_id = state_variables_.size();
@@ -210,6 +239,55 @@ void VarMgr::partition_variables(const std::vector<std::string>& input_names,
   }
 }
 
+void VarMgr::set_reordering_policy(const ReorderingPolicy& policy) {
+  reordering_policy_ = policy;
+}
+
+const ReorderingPolicy& VarMgr::reordering_policy() const {
+  return reordering_policy_;
+}
+
+void VarMgr::enable_reordering() const {
+  mgr_->AutodynEnable(reordering_policy_.cudd_method());
+  mgr_->SetNextReordering(reordering_policy_.first_threshold);
+  mgr_->SetMaxGrowth(reordering_policy_.max_growth);
+}
+
+bool VarMgr::group_variables(const std::vector<CUDD::BDD>& variables) const {
+  if (variables.size() < 2) return false;
+  std::vector<int> levels;
+  for (const auto& variable : variables)
+    levels.push_back(mgr_->ReadPerm(variable.NodeReadIndex()));
+  auto bounds = std::minmax_element(levels.begin(), levels.end());
+  if (static_cast<std::size_t>(*bounds.second - *bounds.first) + 1 != variables.size()) return false;
+  // the group is identified by the index of its top variable
+  mgr_->MakeTreeNode(mgr_->ReadInvPerm(*bounds.first), variables.size(), MTR_DEFAULT);
+  return true;
+}
+
+// CUDD termination callback, aborts operations once the flag is set
+static int cancellation_requested(const void* cancelled) {
+  return static_cast<const std::atomic<bool>*>(cancelled)->load();
+}
+
+void VarMgr::set_cancellation_flag(const std::atomic<bool>* cancelled) {
+  cancelled_ = cancelled;
+  if (cancelled_ == nullptr) {
+    mgr_->UnregisterTerminationCallback();
+  } else {
+    mgr_->RegisterTerminationCallback(
+        cancellation_requested, const_cast<std::atomic<bool>*>(cancelled_));
+  }
+}
+
+const std::atomic<bool>* VarMgr::cancellation_flag() const {
+  return cancelled_;
+}
+
+bool VarMgr::cancelled() const {
+  return cancelled_ != nullptr && cancelled_->load();
+}
+
 std::shared_ptr<CUDD::Cudd> VarMgr::cudd_mgr() const {
   return mgr_;
 }
@@ -429,5 +507,92 @@ std::size_t VarMgr::copy_state_variables(std::size_t automaton_id) {
 
   return copied_vars_id;
 }
-  
+
+void VarMgr::save(std::ostream& out) const {
+  BddSerializer::write_magic(out, "SYFTVAR2");
+  BddSerializer::write_uint(out, mgr_->ReadSize());
+  BddSerializer::write_uint(out, state_variable_count_);
+
+  // named variables in index order, so that equal managers give equal streams
+  std::map<int, std::string> sorted_names(index_to_name_.begin(),
+                                          index_to_name_.end());
+  BddSerializer::write_uint(out, sorted_names.size());
+  for (const auto& index_and_name : sorted_names) {
+    BddSerializer::write_uint(out, index_and_name.first);
+    BddSerializer::write_string(out, index_and_name.second);
+  }
+
+  auto write_variables = [&out](const std::vector<CUDD::BDD>& variables) {
+    BddSerializer::write_uint(out, variables.size());
+    for (const auto& variable : variables)
+      BddSerializer::write_uint(out, variable.NodeReadIndex());
+  };
+  write_variables(input_variables_);
+  write_variables(output_variables_);
+  BddSerializer::write_uint(out, state_variables_.size());
+  for (const auto& variables : state_variables_) write_variables(variables);
+
+  std::map<std::size_t, std::size_t> sorted_next_state_ids(next_state_ids_.begin(),
+                                                           next_state_ids_.end());
+  BddSerializer::write_uint(out, sorted_next_state_ids.size());
+  for (const auto& ids : sorted_next_state_ids) {
+    BddSerializer::write_uint(out, ids.first);
+    BddSerializer::write_uint(out, ids.second);
+  }
+
+  // the variable order, as a stream of no BDDs
+  BddSerializer::write(out, mgr_, {});
+}
+
+std::shared_ptr<VarMgr> VarMgr::load(std::istream& in) {
+  BddSerializer::read_magic(in, "SYFTVAR2");
+  std::shared_ptr<VarMgr> var_mgr = std::make_shared<VarMgr>();
+
+  std::size_t variable_count = BddSerializer::read_uint(in);
+  std::vector<CUDD::BDD> variables;
+  variables.reserve(variable_count);
+  for (std::size_t i = 0; i < variable_count; ++i)
+    variables.push_back(var_mgr->mgr_->bddVar(i));
+  auto read_variable = [&]() {
+    std::size_t index = BddSerializer::read_uint(in);
+    if (index >= variable_count)
+      throw std::runtime_error("Invalid variable in VarMgr stream");
+    return variables[index];
+  };
+
+  var_mgr->state_variable_count_ = BddSerializer::read_uint(in);
+
+  std::size_t named_count = BddSerializer::read_uint(in);
+  for (std::size_t i = 0; i < named_count; ++i) {
+    CUDD::BDD variable = read_variable();
+    std::string name = BddSerializer::read_string(in);
+    var_mgr->name_to_variable_[name] = variable;
+    var_mgr->index_to_name_[variable.NodeReadIndex()] = name;
+  }
+
+  auto read_variables = [&](std::vector<CUDD::BDD>& vector) {
+    std::size_t count = BddSerializer::read_uint(in);
+    vector.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) vector.push_back(read_variable());
+  };
+  read_variables(var_mgr->input_variables_);
+  read_variables(var_mgr->output_variables_);
+  var_mgr->state_variables_.resize(BddSerializer::read_uint(in));
+  for (auto& state_variables : var_mgr->state_variables_)
+    read_variables(state_variables);
+
+  std::size_t next_state_count = BddSerializer::read_uint(in);
+  for (std::size_t i = 0; i < next_state_count; ++i) {
+    std::size_t automaton_id = BddSerializer::read_uint(in);
+    std::size_t next_state_id = BddSerializer::read_uint(in);
+    if (automaton_id >= var_mgr->state_variables_.size() ||
+        next_state_id >= var_mgr->state_variables_.size())
+      throw std::runtime_error("Invalid automaton in VarMgr stream");
+    var_mgr->next_state_ids_[automaton_id] = next_state_id;
+  }
+
+  BddSerializer::read(in, var_mgr->mgr_);
+  return var_mgr;
+}
+
 }
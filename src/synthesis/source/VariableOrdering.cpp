@@ -0,0 +1,105 @@
+/*
+* Definition of class VariableOrdering
+*/
+
+#include"VariableOrdering.h"
+
+#include<algorithm>
+#include<numeric>
+
+namespace Syft {
+
+    VariableOrdering::VariableOrdering(std::size_t variable_count):
+        variable_count_(variable_count), variable_edges_(variable_count) {}
+
+    void VariableOrdering::add_edge(std::vector<int> variables) {
+        std::sort(variables.begin(), variables.end());
+        variables.erase(std::unique(variables.begin(), variables.end()), variables.end());
+        if (variables.size() < 2) return;
+        for (int v : variables) variable_edges_[v].push_back(edges_.size());
+        edges_.push_back(std::move(variables));
+    }
+
+    double VariableOrdering::span(const std::vector<int>& order) const {
+        std::vector<std::size_t> position(variable_count_);
+        for (std::size_t i = 0; i < order.size(); ++i) position[order[i]] = i;
+        double total = 0;
+        for (const auto& edge : edges_) {
+            auto bounds = std::minmax_element(edge.begin(), edge.end(),
+                [&](int lhs, int rhs) { return position[lhs] < position[rhs]; });
+            total += position[*bounds.second] - position[*bounds.first];
+        }
+        return total;
+    }
+
+    std::vector<int> VariableOrdering::interaction_order() const {
+        // score of a variable is the sum, over its constraints, of the
+        // fraction of their variables already placed
+        std::vector<double> score(variable_count_, 0);
+        std::vector<bool> placed(variable_count_, false);
+        std::vector<int> order;
+        order.reserve(variable_count_);
+
+        // starts from the variable in most constraints, ties broken by creation order
+        while (order.size() < variable_count_) {
+            int next = -1;
+            for (std::size_t v = 0; v < variable_count_; ++v) {
+                if (placed[v]) continue;
+                if (next < 0 || score[v] > score[next] ||
+                    (score[v] == score[next] && variable_edges_[v].size() > variable_edges_[next].size()))
+                    next = v;
+            }
+            placed[next] = true;
+            order.push_back(next);
+            for (int e : variable_edges_[next])
+                for (int v : edges_[e])
+                    if (!placed[v]) score[v] += 1.0 / edges_[e].size();
+        }
+        return order;
+    }
+
+    std::vector<int> VariableOrdering::force_order(std::vector<int> order) const {
+        std::vector<double> position(variable_count_);
+        std::vector<double> center(edges_.size());
+        std::vector<int> best_order = order;
+        double best_span = span(order);
+
+        for (std::size_t iteration = 0; iteration < force_max_iterations_; ++iteration) {
+            for (std::size_t i = 0; i < order.size(); ++i) position[order[i]] = i;
+
+            // center of gravity of each constraint
+            for (std::size_t e = 0; e < edges_.size(); ++e) {
+                double sum = 0;
+                for (int v : edges_[e]) sum += position[v];
+                center[e] = sum / edges_[e].size();
+            }
+
+            // each variable moves to the mean center of its constraints.
+            // Variables in no constraint keep their position
+            std::vector<double> target(position);
+            for (std::size_t v = 0; v < variable_count_; ++v) {
+                if (variable_edges_[v].empty()) continue;
+                double sum = 0;
+                for (int e : variable_edges_[v]) sum += center[e];
+                target[v] = sum / variable_edges_[v].size();
+            }
+            std::stable_sort(order.begin(), order.end(), [&](int lhs, int rhs) {
+                return target[lhs] < target[rhs];
+            });
+
+            double order_span = span(order);
+            if (order_span >= best_span) break;
+            best_span = order_span;
+            best_order = order;
+        }
+        return best_order;
+    }
+
+    std::vector<int> VariableOrdering::order(VariableOrderHeuristic heuristic) const {
+        if (heuristic == VariableOrderHeuristic::Interaction) return interaction_order();
+        if (heuristic == VariableOrderHeuristic::Force) return force_order(interaction_order());
+        std::vector<int> order(variable_count_);
+        std::iota(order.begin(), order.end(), 0);
+        return order;
+    }
+}